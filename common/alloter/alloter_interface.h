@@ -6,8 +6,12 @@
 #ifndef COMMON_ALLOTER_ALLOTER_INTERFACE
 #define COMMON_ALLOTER_ALLOTER_INTERFACE
 
+#include <new>
 #include <memory>
+#include <limits>
 #include <cstdint>
+#include <functional>
+#include <unordered_map>
 
 namespace cppnet {
 
@@ -30,14 +34,72 @@ protected:
     }
 };
 
+// memory of the current thread for containers. a dispatcher sets its own,
+// other threads get one when first called.
+std::shared_ptr<Alloter> GetThreadAlloter();
+void SetThreadAlloter(std::shared_ptr<Alloter> alloter);
+
+// standard allocator on cppnet alloter, for containers and std::allocate_shared.
+// memory goes back to the alloter it's taken from, on any thread.
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    // memory moves with the container
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    PoolAllocator() : _alloter(GetThreadAlloter()) {}
+    PoolAllocator(std::shared_ptr<Alloter> alloter) : _alloter(alloter) {}
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : _alloter(other.GetAlloter()) {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<uint32_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        void* ret = _alloter->Malloc((uint32_t)(n * sizeof(T)));
+        if (!ret) {
+            throw std::bad_alloc();
+        }
+        return (T*)ret;
+    }
+    void deallocate(T* p, size_t n) {
+        void* data = (void*)p;
+        _alloter->Free(data, (uint32_t)(n * sizeof(T)));
+    }
+
+    const std::shared_ptr<Alloter>& GetAlloter() const { return _alloter; }
+
+private:
+    std::shared_ptr<Alloter> _alloter;
+};
+
+template<typename T, typename U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) {
+    return a.GetAlloter() == b.GetAlloter();
+}
+
+template<typename T, typename U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) {
+    return !(a == b);
+}
+
+template<typename K, typename V>
+using PoolUnorderedMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, PoolAllocator<std::pair<const K, V>>>;
+
 class AlloterWrap {
 public:
     AlloterWrap(std::shared_ptr<Alloter> a) : _alloter(a) {}
     ~AlloterWrap() {}
 
+    std::shared_ptr<Alloter> GetAlloter() { return _alloter; }
+
     //for object. invocation of constructors and destructors
     template<typename T, typename... Args >
     T* PoolNew(Args&&... args);
+    // object and control block are in one piece of pool memory
     template<typename T, typename... Args >
     std::shared_ptr<T> PoolNewSharePtr(Args&&... args);
 
@@ -72,8 +134,7 @@ T* AlloterWrap::PoolNew(Args&&... args) {
 
 template<typename T, typename... Args >
 std::shared_ptr<T> AlloterWrap::PoolNewSharePtr(Args&&... args) {
-    T* ret = PoolNew<T>(std::forward<Args>(args)...);
-    return std::shared_ptr<T>(ret, [this](T* c) { PoolDelete(c); });
+    return std::allocate_shared<T>(PoolAllocator<T>(_alloter), std::forward<Args>(args)...);
 }
 
 template<typename T>
@@ -98,7 +159,11 @@ T* AlloterWrap::PoolMalloc(uint32_t sz) {
 template<typename T>
 std::shared_ptr<T> AlloterWrap::PoolMallocSharePtr(uint32_t size) {
     T* ret = PoolMalloc<T>(size);
-    return std::shared_ptr<T>(ret, [this, size](T* &c) { PoolFree(c, size); });
+    std::shared_ptr<Alloter> alloter = _alloter;
+    return std::shared_ptr<T>(ret, [alloter, size](T* c) {
+        void* data = (void*)c;
+        alloter->Free(data, size);
+    }, PoolAllocator<T>(_alloter));
 }
     
 template<typename T>
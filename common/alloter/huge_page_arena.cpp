@@ -0,0 +1,148 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef __win__
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+#include <cstdlib>
+
+#include "common/log/log.h"
+#include "common/alloter/huge_page_arena.h"
+
+namespace cppnet {
+
+static const uint32_t __arena_align = 16;
+
+HugePageArena::HugePageArena(uint32_t arena_size):
+    _start(nullptr),
+    _end(nullptr),
+    _explicit_failed(false) {
+    if (arena_size == 0) {
+        arena_size = __huge_page_size;
+    }
+    _arena_size = (arena_size + __huge_page_size - 1) / __huge_page_size * __huge_page_size;
+}
+
+HugePageArena::~HugePageArena() {
+    for (auto& arena : _arenas) {
+#ifdef __win__
+        free(arena._mem);
+#else
+        munmap(arena._mem, arena._size);
+#endif
+    }
+    _arenas.clear();
+}
+
+void* HugePageArena::Malloc(uint32_t size, uint32_t align) {
+    if (align < __arena_align) {
+        align = __arena_align;
+    }
+    size = (size + __arena_align - 1) & ~(__arena_align - 1);
+    if (size == 0) {
+        size = __arena_align;
+    }
+    // arenas are aligned to huge page
+    char* start = (char*)(((uintptr_t)_start + align - 1) & ~(uintptr_t)(align - 1));
+    // the tail of last arena is dropped
+    if (!_start || start > _end || (uint64_t)(_end - start) < size) {
+        if (!NewArena(size)) {
+            return nullptr;
+        }
+        start = _start;
+    }
+    _start = start + size;
+    return start;
+}
+
+uint32_t HugePageArena::GetArenaNum(uint16_t type) {
+    uint32_t num = 0;
+    for (auto& arena : _arenas) {
+        if (arena._type == type) {
+            num++;
+        }
+    }
+    return num;
+}
+
+uint64_t HugePageArena::GetArenaBytes() {
+    uint64_t bytes = 0;
+    for (auto& arena : _arenas) {
+        bytes += arena._size;
+    }
+    return bytes;
+}
+
+bool HugePageArena::NewArena(uint32_t size) {
+    uint64_t arena_size = _arena_size;
+    if (size > arena_size) {
+        arena_size = ((uint64_t)size + __huge_page_size - 1) / __huge_page_size * __huge_page_size;
+    }
+
+    Arena arena;
+    arena._size = arena_size;
+#ifdef __win__
+    arena._mem = (char*)malloc(arena_size);
+    arena._type = HPT_NORMAL;
+    if (!arena._mem) {
+        LOG_ERROR("malloc arena failed. size:%llu", (unsigned long long)arena_size);
+        return false;
+    }
+#else
+    arena._mem = nullptr;
+#ifdef MAP_HUGETLB
+    if (!_explicit_failed) {
+        void* mem = mmap(nullptr, arena_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            arena._mem = (char*)mem;
+            arena._type = HPT_EXPLICIT;
+
+        } else {
+            // no reserved huge pages, don't try again
+            _explicit_failed = true;
+            LOG_INFO("reserved huge pages are unavailable, use transparent huge pages. errno:%d", errno);
+        }
+    }
+#endif
+    if (!arena._mem) {
+        // map one more huge page to align the arena to huge page
+        uint64_t map_size = arena_size + __huge_page_size;
+        void* mem = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            LOG_ERROR("mmap arena failed. size:%llu, errno:%d", (unsigned long long)map_size, errno);
+            return false;
+        }
+        uintptr_t start = ((uintptr_t)mem + __huge_page_size - 1) & ~(uintptr_t)(__huge_page_size - 1);
+        uint64_t head = start - (uintptr_t)mem;
+        if (head > 0) {
+            munmap(mem, head);
+        }
+        uint64_t tail = map_size - head - arena_size;
+        if (tail > 0) {
+            munmap((char*)start + arena_size, tail);
+        }
+        arena._mem = (char*)start;
+        arena._type = HPT_NORMAL;
+#ifdef MADV_HUGEPAGE
+        // fails if transparent huge pages are disabled
+        if (madvise(arena._mem, arena_size, MADV_HUGEPAGE) == 0) {
+            arena._type = HPT_TRANSPARENT;
+        }
+#endif
+    }
+#endif
+    _arenas.push_back(arena);
+    _start = arena._mem;
+    _end = arena._mem + arena_size;
+    return true;
+}
+
+std::shared_ptr<HugePageArena> MakeHugePageArenaPtr(uint32_t arena_size) {
+    return std::make_shared<HugePageArena>(arena_size);
+}
+
+}
@@ -0,0 +1,64 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_ALLOTER_HUGE_PAGE_ARENA
+#define COMMON_ALLOTER_HUGE_PAGE_ARENA
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace cppnet {
+
+static const uint32_t __huge_page_size = 1024 * 1024 * 2;
+
+enum HugePageType {
+    HPT_EXPLICIT    = 0, // reserved huge pages, MAP_HUGETLB
+    HPT_TRANSPARENT = 1, // transparent huge pages, madvise MADV_HUGEPAGE
+    HPT_NORMAL      = 2, // huge pages are unavailable, normal pages
+    HPT_TYPE_NUM    = 3,
+};
+
+// carve memory out of large arenas backed by huge pages, to reduce tlb misses.
+// reserved huge pages are tried first, then transparent huge pages, then normal pages.
+// memory can't be freed one by one, it's returned to system when arena is destroyed.
+// not thread safe, one arena for one dispatcher.
+class HugePageArena {
+public:
+    // arena_size is rounded up to huge page size
+    HugePageArena(uint32_t arena_size = __huge_page_size);
+    ~HugePageArena();
+
+    // return memory aligned to align bytes, at least 16 and not more than huge page size.
+    // nullptr if system memory is out.
+    void* Malloc(uint32_t size, uint32_t align = 16);
+
+    // number of arenas of each HugePageType
+    uint32_t GetArenaNum(uint16_t type);
+    // bytes of all arenas
+    uint64_t GetArenaBytes();
+
+private:
+    bool NewArena(uint32_t size);
+
+private:
+    struct Arena {
+        char*    _mem;
+        uint64_t _size;
+        uint16_t _type;
+    };
+    uint32_t           _arena_size;
+    char*              _start;
+    char*              _end;
+    // skip explicit huge pages after failed once
+    bool               _explicit_failed;
+    std::vector<Arena> _arenas;
+};
+
+std::shared_ptr<HugePageArena> MakeHugePageArenaPtr(uint32_t arena_size = __huge_page_size);
+
+}
+
+#endif
@@ -8,13 +8,15 @@
 
 #include "common/alloter/pool_alloter.h"
 #include "common/alloter/normal_alloter.h"
+#include "common/alloter/huge_page_arena.h"
 
 namespace cppnet {
 
 
-PoolAlloter::PoolAlloter() : 
+PoolAlloter::PoolAlloter(std::shared_ptr<HugePageArena> arena) : 
     _pool_start(nullptr),
-    _pool_end(nullptr) {
+    _pool_end(nullptr),
+    _arena(arena) {
     _free_list.resize(__default_number_of_free_lists);
     memset(&(*_free_list.begin()), 0, sizeof(void*) * __default_number_of_free_lists);
     _alloter = MakeNormalAlloterPtr();
@@ -139,15 +141,19 @@ void* PoolAlloter::ChunkAlloc(uint32_t size, uint32_t& nums) {
         _free_list[FreeListIndex(size)] = (MemNode*)_pool_start;
     }
 
-    _pool_start = (char*)_alloter->Malloc(bytes_to_get);
+    if (_arena) {
+        _pool_start = (char*)_arena->Malloc(bytes_to_get);
 
-    _malloc_vec.push_back(_pool_start);
+    } else {
+        _pool_start = (char*)_alloter->Malloc(bytes_to_get);
+        _malloc_vec.push_back(_pool_start);
+    }
     _pool_end = _pool_start + bytes_to_get;
     return ChunkAlloc(size, nums);
 }
 
-std::shared_ptr<Alloter> MakePoolAlloterPtr() {
-    return std::make_shared<cppnet::PoolAlloter>();
+std::shared_ptr<Alloter> MakePoolAlloterPtr(std::shared_ptr<HugePageArena> arena) {
+    return std::make_shared<cppnet::PoolAlloter>(arena);
 }
 
 }
\ No newline at end of file
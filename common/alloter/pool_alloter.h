@@ -19,9 +19,12 @@ static const uint32_t __default_max_bytes = 256;
 static const uint32_t __default_number_of_free_lists = __default_max_bytes / __align;
 static const uint32_t __default_number_add_nodes = 20;
 
+class HugePageArena;
+
 class PoolAlloter : public Alloter {
 public:
-    PoolAlloter();
+    // chunks are carved out of arena if set
+    PoolAlloter(std::shared_ptr<HugePageArena> arena = nullptr);
     ~PoolAlloter();
 
     void* Malloc(uint32_t size);
@@ -51,9 +54,10 @@ private:
     std::vector<MemNode*> _free_list;  
     std::vector<char*>    _malloc_vec;
     std::shared_ptr<Alloter> _alloter;
+    std::shared_ptr<HugePageArena> _arena;
 };
 
-std::shared_ptr<Alloter> MakePoolAlloterPtr();
+std::shared_ptr<Alloter> MakePoolAlloterPtr(std::shared_ptr<HugePageArena> arena = nullptr);
 
 }
 
@@ -5,58 +5,90 @@
 
 #include <cstdlib>
 #include <algorithm>
+#include "common/log/log.h"
 #include "cppnet/cppnet_config.h"
 #include "common/alloter/pool_block.h"
+#include "common/alloter/huge_page_arena.h"
 
 namespace cppnet {
 
 
-BlockMemoryPool::BlockMemoryPool(uint32_t large_sz, uint32_t add_num) :
+BlockMemoryPool::BlockMemoryPool(uint32_t large_sz, uint32_t add_num, uint16_t class_num,
+    std::shared_ptr<HugePageArena> arena) :
     _number_large_add_nodes(add_num),
-    _large_size(large_sz) {
+    _arena(arena) {
 
+    if (class_num == 0) {
+        class_num = 1;
+    }
+    _classes.resize(class_num);
+    uint32_t size = large_sz;
+    for (uint16_t i = 0; i < class_num; i++) {
+        _classes[i]._size = size;
+        // cache as many bytes as the smallest class, at least one node
+        _classes[i]._max_num = std::max<uint32_t>(__max_block_num * large_sz / size, 1);
+        size *= __mem_block_class_times;
+    }
 }
 
 BlockMemoryPool::~BlockMemoryPool() {
 #ifdef __use_iocp__
     std::lock_guard<std::mutex> lock(_mutex);
 #endif
-    // free all memory
-    for (auto iter = _free_mem_vec.begin(); iter != _free_mem_vec.end(); ++iter) {
-        free(*iter);
+    // free all memory, arena memory is freed by arena
+    for (auto& size_class : _classes) {
+        if (_arena) {
+            size_class._free_mem_vec.clear();
+            continue;
+        }
+        for (auto iter = size_class._free_mem_vec.begin(); iter != size_class._free_mem_vec.end(); ++iter) {
+            free(*iter);
+        }
+        size_class._free_mem_vec.clear();
     }
-    _free_mem_vec.clear();
 }
 
 void* BlockMemoryPool::PoolLargeMalloc() {
+    uint32_t block_len = 0;
+    return PoolLargeMalloc(0, block_len);
+}
+
+void BlockMemoryPool::PoolLargeFree(void* &m) {
+    PoolLargeFree(m, _classes[0]._size);
+}
+
+void* BlockMemoryPool::PoolLargeMalloc(uint32_t size, uint32_t& block_len) {
 #ifdef __use_iocp__
     std::lock_guard<std::mutex> lock(_mutex);
 #endif
-    if (_free_mem_vec.empty()) {
-        Expansion();
+    SizeClass& size_class = GetClass(size);
+    if (size_class._free_mem_vec.empty()) {
+        // large memory is added one by one
+        Expansion(size_class, &size_class == &_classes[0] ? _number_large_add_nodes : 1);
+        if (size_class._free_mem_vec.empty()) {
+            block_len = 0;
+            return nullptr;
+        }
     }
 
-    void* ret = _free_mem_vec.back();
-    _free_mem_vec.pop_back();
+    void* ret = size_class._free_mem_vec.back();
+    size_class._free_mem_vec.pop_back();
+    size_class._min_free = std::min(size_class._min_free, size_class._free_mem_vec.size());
+    block_len = size_class._size;
     return ret;
 }
 
-void BlockMemoryPool::PoolLargeFree(void* &m) {
-    bool release = false;
-    {
+void BlockMemoryPool::PoolLargeFree(void* &m, uint32_t block_len) {
 #ifdef __use_iocp__
-        std::lock_guard<std::mutex> lock(_mutex);
+    std::lock_guard<std::mutex> lock(_mutex);
 #endif
-        _free_mem_vec.push_back(m);
+    SizeClass& size_class = GetClass(block_len);
+    size_class._free_mem_vec.push_back(m);
+    m = nullptr;
 
-        if (_free_mem_vec.size() > __max_block_num) {
-            release = true;
-        }
-    }
-    
-    // release some block.
-    if (release) {
-        ReleaseHalf();
+    // release some block. arena blocks are kept for reuse.
+    if (!_arena && size_class._free_mem_vec.size() > size_class._max_num) {
+        ReleaseHalf(size_class);
     }
 }
 
@@ -64,46 +96,99 @@ uint32_t BlockMemoryPool::GetSize() {
 #ifdef __use_iocp__
     std::lock_guard<std::mutex> lock(_mutex);
 #endif
-    return (uint32_t)_free_mem_vec.size();
+    uint32_t size = 0;
+    for (auto& size_class : _classes) {
+        size += (uint32_t)size_class._free_mem_vec.size();
+    }
+    return size;
 }
 
 uint32_t BlockMemoryPool::GetBlockLength() {
-    return _large_size;
+    return _classes[0]._size;
 }
 
-void BlockMemoryPool::ReleaseHalf() {
+uint32_t BlockMemoryPool::GetBlockLength(uint32_t size) {
+    return GetClass(size)._size;
+}
+
+uint64_t BlockMemoryPool::Trim() {
 #ifdef __use_iocp__
     std::lock_guard<std::mutex> lock(_mutex);
 #endif
-    size_t size = _free_mem_vec.size();
-    size_t hale = size / 2;
-    for (auto iter = _free_mem_vec.begin(); iter != _free_mem_vec.end();) {
-        void* mem = *iter;
-
-        iter = _free_mem_vec.erase(iter);
-        free(mem);
-        
-        size--;
-        if (iter == _free_mem_vec.end() || size <= hale) {
-            break;
+    uint64_t bytes = 0;
+    for (auto& size_class : _classes) {
+        auto& free_mem_vec = size_class._free_mem_vec;
+        size_t release = std::min(size_class._min_free, free_mem_vec.size());
+        if (!_arena && release > 0) {
+            // the first ones are freed earliest
+            for (size_t i = 0; i < release; i++) {
+                free(free_mem_vec[i]);
+            }
+            free_mem_vec.erase(free_mem_vec.begin(), free_mem_vec.begin() + release);
+            bytes += (uint64_t)release * size_class._size;
         }
+        size_class._min_free = free_mem_vec.size();
+    }
+    return bytes;
+}
+
+void BlockMemoryPool::ReleaseHalf() {
+#ifdef __use_iocp__
+    std::lock_guard<std::mutex> lock(_mutex);
+#endif
+    for (auto& size_class : _classes) {
+        ReleaseHalf(size_class);
     }
 }
 
 void BlockMemoryPool::Expansion(uint32_t num) {
+#ifdef __use_iocp__
+    std::lock_guard<std::mutex> lock(_mutex);
+#endif
     if (num == 0) {
         num = _number_large_add_nodes;
     }
+    Expansion(_classes[0], num);
+}
 
+BlockMemoryPool::SizeClass& BlockMemoryPool::GetClass(uint32_t size) {
+    // never waste more than a smallest block for small data
+    for (size_t i = _classes.size() - 1; i > 0; i--) {
+        if (size >= _classes[i]._size) {
+            return _classes[i];
+        }
+    }
+    return _classes[0];
+}
+
+void BlockMemoryPool::ReleaseHalf(SizeClass& size_class) {
+    if (_arena) {
+        return;
+    }
+    auto& free_mem_vec = size_class._free_mem_vec;
+    // the last ones are freed recently, keep them
+    size_t release = free_mem_vec.size() - free_mem_vec.size() / 2;
+    for (size_t i = 0; i < release; i++) {
+        free(free_mem_vec[i]);
+    }
+    free_mem_vec.erase(free_mem_vec.begin(), free_mem_vec.begin() + release);
+}
+
+void BlockMemoryPool::Expansion(SizeClass& size_class, uint32_t num) {
     for (uint32_t i = 0; i < num; ++i) {
-        void* mem = malloc(_large_size);
+        void* mem = _arena ? _arena->Malloc(size_class._size) : malloc(size_class._size);
+        if (!mem) {
+            LOG_ERROR("malloc block failed. size:%u", size_class._size);
+            return;
+        }
         // not memset!
-        _free_mem_vec.push_back(mem);
+        size_class._free_mem_vec.push_back(mem);
     }
 }
 
-std::shared_ptr<BlockMemoryPool> MakeBlockMemoryPoolPtr(uint32_t large_sz, uint32_t add_num) {
-    return std::make_shared<BlockMemoryPool>(large_sz, add_num);
+std::shared_ptr<BlockMemoryPool> MakeBlockMemoryPoolPtr(uint32_t large_sz, uint32_t add_num, uint16_t class_num,
+    std::shared_ptr<HugePageArena> arena) {
+    return std::make_shared<BlockMemoryPool>(large_sz, add_num, class_num, arena);
 }
 
-}
\ No newline at end of file
+}
@@ -15,39 +15,71 @@
 
 namespace cppnet {
 
+class HugePageArena;
+
 // all memory must return memory pool before destroy.
+// there may be some size classes, every class is
+// __mem_block_class_times times of the last one.
 class BlockMemoryPool {
 public:
-    // bulk memory size. 
+    // bulk memory size of the smallest class. 
     // every time add nodes num
-    BlockMemoryPool(uint32_t large_sz, uint32_t add_num);
+    // number of size classes
+    // blocks are carved out of arena if set, and never freed one by one.
+    BlockMemoryPool(uint32_t large_sz, uint32_t add_num, uint16_t class_num = 1,
+        std::shared_ptr<HugePageArena> arena = nullptr);
     virtual ~BlockMemoryPool();
 
     // for bulk memory. 
-    // return one bulk memory node
+    // return one bulk memory node of the smallest class, nullptr if out of memory
     virtual void* PoolLargeMalloc();
     virtual void PoolLargeFree(void* &m);
 
-    // return bulk memory list size
+    // return one bulk memory node of the class for expected size,
+    // block_len returns the length of memory, 0 if out of memory.
+    virtual void* PoolLargeMalloc(uint32_t size, uint32_t& block_len);
+    // block_len must be the length returned by malloc
+    virtual void PoolLargeFree(void* &m, uint32_t block_len);
+
+    // return bulk memory list size of all classes
     virtual uint32_t GetSize();
-    // return length of bulk memory
+    // return length of bulk memory of the smallest class
     virtual uint32_t GetBlockLength();
+    // return length of bulk memory for expected size.
+    // the largest class not more than size, or the smallest class.
+    virtual uint32_t GetBlockLength(uint32_t size);
+
+    // release blocks not taken since last trim, for shrinking after traffic spikes.
+    // return bytes released. arena blocks are never released.
+    virtual uint64_t Trim();
 
     // release half memory
     virtual void ReleaseHalf();
     virtual void Expansion(uint32_t num = 0);
 
+private:
+    struct SizeClass {
+        uint32_t           _size;         //bulk memory size
+        uint32_t           _max_num;      //max free nodes num
+        std::vector<void*> _free_mem_vec; //free bulk memory list
+        size_t             _min_free = 0; //least free nodes num since last trim
+    };
+    SizeClass& GetClass(uint32_t size);
+    void ReleaseHalf(SizeClass& size_class);
+    void Expansion(SizeClass& size_class, uint32_t num);
+
 private:
 #ifdef __use_iocp__
     std::mutex                _mutex;
 #endif
     uint32_t                  _number_large_add_nodes; //every time add nodes num
-    uint32_t                  _large_size;             //bulk memory size
-    std::vector<void*>        _free_mem_vec;           //free bulk memory list
+    std::vector<SizeClass>    _classes;                //from small to large
+    std::shared_ptr<HugePageArena> _arena;
 };
 
-std::shared_ptr<BlockMemoryPool> MakeBlockMemoryPoolPtr(uint32_t large_sz, uint32_t add_num);
+std::shared_ptr<BlockMemoryPool> MakeBlockMemoryPoolPtr(uint32_t large_sz, uint32_t add_num, uint16_t class_num = 1,
+    std::shared_ptr<HugePageArena> arena = nullptr);
 
 }
 
-#endif
\ No newline at end of file
+#endif
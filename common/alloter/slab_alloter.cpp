@@ -0,0 +1,298 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <cstring>
+#include <cstdlib>
+#ifdef __win__
+#include <malloc.h>
+#endif
+
+#include "common/log/log.h"
+#include "common/alloter/slab_alloter.h"
+#include "common/alloter/normal_alloter.h"
+#include "common/alloter/huge_page_arena.h"
+
+namespace cppnet {
+
+// objects start after slab head
+static const uint32_t __slab_head_size = 128;
+
+static thread_local std::shared_ptr<Alloter> __thread_alloter;
+
+std::shared_ptr<Alloter> GetThreadAlloter() {
+    if (!__thread_alloter) {
+        auto alloter = MakeSlabAlloterPtr();
+        alloter->SetOwnerThread();
+        __thread_alloter = alloter;
+    }
+    return __thread_alloter;
+}
+
+void SetThreadAlloter(std::shared_ptr<Alloter> alloter) {
+    __thread_alloter = alloter;
+}
+
+SlabAlloter::SlabAlloter(std::shared_ptr<HugePageArena> arena):
+    _has_owner(false),
+    _remote_free(nullptr),
+    _all_slabs(nullptr),
+    _slab_bytes(0),
+    _arena(arena) {
+    static_assert(sizeof(Slab) <= __slab_head_size, "slab head is too large");
+    _alloter = MakeNormalAlloterPtr();
+}
+
+SlabAlloter::~SlabAlloter() {
+    // memory freed by other threads after owner stopped, no one else uses it now
+    DrainRemoteFree();
+
+    Slab* slab = _all_slabs;
+    while (slab) {
+        Slab* next = slab->_all_next;
+        if (!slab->_in_arena) {
+#ifdef __win__
+            _aligned_free(slab);
+#else
+            free(slab);
+#endif
+        }
+        slab = next;
+    }
+    _all_slabs = nullptr;
+}
+
+void* SlabAlloter::Malloc(uint32_t size) {
+    if (size > __slab_max_bytes) {
+        return _alloter->Malloc(size);
+    }
+    if (size == 0) {
+        size = 1;
+    }
+
+    uint16_t index = ClassIndex(size);
+    if (IsOwner()) {
+        return SlabMalloc(_local, index, false);
+    }
+
+    std::lock_guard<std::mutex> lock(_shared_mutex);
+    return SlabMalloc(_shared, index, true);
+}
+
+void* SlabAlloter::MallocAlign(uint32_t size) {
+    return Malloc(Align(size));
+}
+
+void* SlabAlloter::MallocZero(uint32_t size) {
+    void* ret = Malloc(size);
+    if (ret) {
+        memset(ret, 0, size);
+    }
+    return ret;
+}
+
+void SlabAlloter::Free(void* &data, uint32_t len) {
+    if (!data) {
+        return;
+    }
+
+    if (len > __slab_max_bytes) {
+        _alloter->Free(data);
+        data = nullptr;
+        return;
+    }
+
+    Slab* slab = GetSlab(data);
+    if (slab->_shared) {
+        std::lock_guard<std::mutex> lock(_shared_mutex);
+        SlabFree(_shared, slab, data);
+
+    } else if (IsOwner()) {
+        SlabFree(_local, slab, data);
+
+    } else {
+        // owner puts it back later
+        MemNode* node = (MemNode*)data;
+        node->_next = _remote_free.load(std::memory_order_relaxed);
+        while (!_remote_free.compare_exchange_weak(node->_next, node,
+            std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    data = nullptr;
+}
+
+void SlabAlloter::SetOwnerThread() {
+    _owner = std::this_thread::get_id();
+    _has_owner.store(true, std::memory_order_release);
+}
+
+void SlabAlloter::DrainRemoteFree() {
+    if (!_remote_free.load(std::memory_order_relaxed)) {
+        return;
+    }
+    MemNode* node = _remote_free.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+        MemNode* next = node->_next;
+        SlabFree(_local, GetSlab(node), node);
+        node = next;
+    }
+}
+
+uint64_t SlabAlloter::GetSlabBytes() {
+    std::lock_guard<std::mutex> lock(_slabs_mutex);
+    return _slab_bytes;
+}
+
+bool SlabAlloter::IsOwner() {
+    // no owner yet, every thread takes shared slabs with lock
+    return _has_owner.load(std::memory_order_acquire) && std::this_thread::get_id() == _owner;
+}
+
+void* SlabAlloter::SlabMalloc(SlabList* lists, uint16_t index, bool shared) {
+    SlabList& list = lists[index];
+    if (!list._partial && !shared) {
+        DrainRemoteFree();
+    }
+
+    Slab* slab = list._partial;
+    if (!slab) {
+        slab = NewSlab(index, shared);
+        if (!slab) {
+            return nullptr;
+        }
+        PushPartial(list, slab);
+    }
+
+    uint32_t size = (index + 1) * __slab_class_align;
+    void* ret = nullptr;
+    if (slab->_free) {
+        ret = slab->_free;
+        slab->_free = slab->_free->_next;
+
+    } else {
+        ret = slab->_bump;
+        slab->_bump += size;
+    }
+    slab->_used++;
+
+    // slab is full
+    if (!slab->_free && slab->_bump + size > (char*)slab + __slab_size) {
+        RemovePartial(list, slab);
+    }
+    return ret;
+}
+
+void SlabAlloter::SlabFree(SlabList* lists, Slab* slab, void* data) {
+    SlabList& list = lists[slab->_class];
+    MemNode* node = (MemNode*)data;
+    node->_next = slab->_free;
+    slab->_free = node;
+    slab->_used--;
+
+    if (!slab->_partial) {
+        PushPartial(list, slab);
+    }
+
+    // keep the last slab of class
+    if (slab->_used == 0 && !slab->_in_arena && (slab->_prev || slab->_next)) {
+        RemovePartial(list, slab);
+        ReleaseSlab(slab);
+    }
+}
+
+SlabAlloter::Slab* SlabAlloter::NewSlab(uint16_t index, bool shared) {
+    void* mem = nullptr;
+    bool in_arena = false;
+    // arena is not locked, only for owner
+    if (_arena && !shared) {
+        mem = _arena->Malloc(__slab_size, __slab_size);
+        in_arena = mem != nullptr;
+    }
+    if (!mem) {
+#ifdef __win__
+        mem = _aligned_malloc(__slab_size, __slab_size);
+#else
+        if (posix_memalign(&mem, __slab_size, __slab_size) != 0) {
+            mem = nullptr;
+        }
+#endif
+    }
+    if (!mem) {
+        LOG_ERROR("malloc slab failed. size:%u", __slab_size);
+        return nullptr;
+    }
+
+    Slab* slab = (Slab*)mem;
+    slab->_prev = nullptr;
+    slab->_next = nullptr;
+    slab->_free = nullptr;
+    slab->_bump = (char*)mem + __slab_head_size;
+    slab->_used = 0;
+    slab->_class = index;
+    slab->_shared = shared;
+    slab->_partial = false;
+    slab->_in_arena = in_arena;
+
+    std::lock_guard<std::mutex> lock(_slabs_mutex);
+    slab->_all_prev = nullptr;
+    slab->_all_next = _all_slabs;
+    if (_all_slabs) {
+        _all_slabs->_all_prev = slab;
+    }
+    _all_slabs = slab;
+    _slab_bytes += __slab_size;
+    return slab;
+}
+
+void SlabAlloter::ReleaseSlab(Slab* slab) {
+    {
+        std::lock_guard<std::mutex> lock(_slabs_mutex);
+        if (slab->_all_prev) {
+            slab->_all_prev->_all_next = slab->_all_next;
+
+        } else {
+            _all_slabs = slab->_all_next;
+        }
+        if (slab->_all_next) {
+            slab->_all_next->_all_prev = slab->_all_prev;
+        }
+        _slab_bytes -= __slab_size;
+    }
+#ifdef __win__
+    _aligned_free(slab);
+#else
+    free(slab);
+#endif
+}
+
+void SlabAlloter::PushPartial(SlabList& list, Slab* slab) {
+    slab->_prev = nullptr;
+    slab->_next = list._partial;
+    if (list._partial) {
+        list._partial->_prev = slab;
+    }
+    list._partial = slab;
+    slab->_partial = true;
+}
+
+void SlabAlloter::RemovePartial(SlabList& list, Slab* slab) {
+    if (slab->_prev) {
+        slab->_prev->_next = slab->_next;
+
+    } else {
+        list._partial = slab->_next;
+    }
+    if (slab->_next) {
+        slab->_next->_prev = slab->_prev;
+    }
+    slab->_prev = nullptr;
+    slab->_next = nullptr;
+    slab->_partial = false;
+}
+
+std::shared_ptr<SlabAlloter> MakeSlabAlloterPtr(std::shared_ptr<HugePageArena> arena) {
+    return std::make_shared<SlabAlloter>(arena);
+}
+
+}
@@ -0,0 +1,107 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_ALLOTER_SLAB_ALLOTER
+#define COMMON_ALLOTER_SLAB_ALLOTER
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include "common/alloter/alloter_interface.h"
+
+namespace cppnet {
+
+// every slab is aligned to its size, the head of slab is found by address.
+static const uint32_t __slab_size = 64 * 1024;
+static const uint32_t __slab_class_align = 16;
+// larger memory is taken from system
+static const uint32_t __slab_max_bytes = 256;
+static const uint32_t __slab_class_num = __slab_max_bytes / __slab_class_align;
+
+class HugePageArena;
+
+// small objects of one dispatcher. objects of one size class are cut from slabs,
+// a slab goes back to system when all its objects are freed.
+// the owner thread takes and frees memory without lock. other threads take memory
+// from shared slabs with lock, and memory of owner is given back by a lock free
+// list, the owner puts it back to slabs later.
+class SlabAlloter : public Alloter {
+public:
+    // slabs of owner are carved out of arena if set, and kept until destroyed
+    SlabAlloter(std::shared_ptr<HugePageArena> arena = nullptr);
+    ~SlabAlloter();
+
+    void* Malloc(uint32_t size);
+    void* MallocAlign(uint32_t size);
+    void* MallocZero(uint32_t size);
+
+    void Free(void* &data, uint32_t len);
+
+    // call in the owner thread. before it's set, every thread takes memory with lock.
+    void SetOwnerThread();
+    // put memory freed by other threads back to slabs, only in owner thread.
+    void DrainRemoteFree();
+
+    // bytes of all slabs
+    uint64_t GetSlabBytes();
+
+private:
+    struct MemNode {
+        MemNode* _next;
+    };
+    struct Slab {
+        Slab*    _prev;     // slabs with free objects of the class
+        Slab*    _next;
+        Slab*    _all_prev; // all slabs
+        Slab*    _all_next;
+        MemNode* _free;     // freed objects
+        char*    _bump;     // objects never used start here
+        uint32_t _used;
+        uint16_t _class;
+        bool     _shared;   // used by other threads with lock
+        bool     _partial;  // in list of slabs with free objects
+        bool     _in_arena; // can't be freed
+    };
+    struct SlabList {
+        Slab* _partial = nullptr;
+    };
+
+    bool IsOwner();
+    uint16_t ClassIndex(uint32_t size) { return (uint16_t)((size + __slab_class_align - 1) / __slab_class_align - 1); }
+    static Slab* GetSlab(void* data) { return (Slab*)((uintptr_t)data & ~(uintptr_t)(__slab_size - 1)); }
+
+    void* SlabMalloc(SlabList* lists, uint16_t index, bool shared);
+    void SlabFree(SlabList* lists, Slab* slab, void* data);
+    Slab* NewSlab(uint16_t index, bool shared);
+    void ReleaseSlab(Slab* slab);
+    void PushPartial(SlabList& list, Slab* slab);
+    void RemovePartial(SlabList& list, Slab* slab);
+
+private:
+    std::atomic<bool> _has_owner;
+    std::thread::id   _owner;
+
+    SlabList   _local[__slab_class_num];
+    // slabs for other threads
+    std::mutex _shared_mutex;
+    SlabList   _shared[__slab_class_num];
+    // memory of owner freed by other threads
+    std::atomic<MemNode*> _remote_free;
+
+    // list of all slabs
+    std::mutex _slabs_mutex;
+    Slab*      _all_slabs;
+    uint64_t   _slab_bytes;
+
+    std::shared_ptr<Alloter>       _alloter;
+    std::shared_ptr<HugePageArena> _arena;
+};
+
+std::shared_ptr<SlabAlloter> MakeSlabAlloterPtr(std::shared_ptr<HugePageArena> arena = nullptr);
+
+}
+
+#endif
@@ -5,26 +5,71 @@
 
 #include <cstring>
 #include "common/alloter/pool_block.h"
+#include "common/util/find_str.h"
 #include "common/buffer/buffer_block.h"
+#include "common/alloter/alloter_interface.h"
 
 namespace cppnet {
 
-BufferBlock::BufferBlock(std::shared_ptr<BlockMemoryPool>& alloter) : 
+BufferBlock::BufferBlock(std::shared_ptr<BlockMemoryPool>& alloter, uint32_t size) : 
     _can_read(false),
+    _share_count(0),
     _alloter(alloter) {
 
-    _buffer_start = (char*)alloter->PoolLargeMalloc();
-    _total_size = alloter->GetBlockLength();
+    _buffer_start = (char*)alloter->PoolLargeMalloc(size, _total_size);
     _buffer_end = _buffer_start + _total_size;
     _read = _write = _buffer_start;
 }
 
+BufferBlock::BufferBlock(std::shared_ptr<BufferBlock> origin, uint32_t len,
+    std::shared_ptr<AlloterWrap> alloter) :
+    _share_count(0),
+    _origin_alloter(alloter) {
+
+    // slice of slice refers to the memory owner
+    if (origin->_origin) {
+        _origin_alloter = origin->_origin_alloter;
+        _origin = origin->_origin;
+
+    } else {
+        _origin = origin;
+    }
+    _origin->_share_count++;
+    _origin_pool = origin->GetBlockMemoryPool();
+    _alloter = _origin_pool;
+
+    _buffer_start = origin->_buffer_start;
+    _buffer_end = origin->_buffer_end;
+    _total_size = origin->_total_size;
+
+    uint32_t can_read = origin->GetCanReadLength();
+    if (len > can_read) {
+        len = can_read;
+    }
+    _read = origin->_read;
+    if (len <= (uint32_t)(_buffer_end - _read)) {
+        _write = _read + len;
+
+    } else {
+        _write = _buffer_start + (len - (_buffer_end - _read));
+    }
+    if (_write == _buffer_end) {
+        _write = _buffer_start;
+    }
+    _can_read = len > 0 && _read == _write;
+}
+
 BufferBlock::~BufferBlock() {
+    if (_origin) {
+        _origin->_share_count--;
+        return;
+    }
+
     if (_buffer_start) {
         auto alloter = _alloter.lock();
         if (alloter) {
             void* m = (void*)_buffer_start;
-            alloter->PoolLargeFree(m);
+            alloter->PoolLargeFree(m, _total_size);
         }
     }
 }
@@ -77,7 +122,7 @@ uint32_t BufferBlock::Write(std::shared_ptr<InnerBuffer> buffer, uint32_t len) {
         len = buffer->GetCanReadLength();
     }
 
-    if (!_buffer_start) {
+    if (!_buffer_start || IsShared()) {
         return 0;
     }
 
@@ -120,7 +165,7 @@ uint32_t BufferBlock::Read(char* res, uint32_t len) {
 }
 
 uint32_t BufferBlock::Write(const char* data, uint32_t len) {
-    if (data == nullptr) {
+    if (data == nullptr || IsShared()) {
         return 0;
     }
     return _Write(data, len);
@@ -228,7 +273,7 @@ int32_t BufferBlock::MoveReadPt(int32_t len) {
 }
 
 int32_t BufferBlock::MoveWritePt(int32_t len) {
-    if (!_buffer_start) {
+    if (!_buffer_start || IsShared()) {
         return 0;
     }
 
@@ -349,6 +394,10 @@ uint32_t BufferBlock::ReadUntil(char* res, uint32_t len, const char* find, uint3
 }
     
 uint32_t BufferBlock::GetCanWriteLength() {
+    if (IsShared()) {
+        return 0;
+    }
+
     if (_write > _read) {
         return (uint32_t)((_buffer_end - _write) + (_read - _buffer_start));
     
@@ -386,6 +435,10 @@ bool BufferBlock::GetFreeMemoryBlock(void*& res1, uint32_t& len1, void*& res2, u
     res1 = res2 = nullptr;
     len1 = len2 = 0;
 
+    if (IsShared()) {
+        return false;
+    }
+
     if (_write >= _read) {
         if (_can_read && _write == _read) {
             return false;
@@ -430,20 +483,100 @@ bool BufferBlock::GetUseMemoryBlock(void*& res1, uint32_t& len1, void*& res2, ui
     }
 }
 
+uint32_t BufferBlock::GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t size) {
+    void* mem1 = nullptr, *mem2 = nullptr;
+    uint32_t len1 = 0, len2 = 0;
+    GetFreeMemoryBlock(mem1, len1, mem2, len2);
+
+    if (size > 0) {
+        if (len1 >= size) {
+            len1 = size;
+            len2 = 0;
+
+        } else if (len1 + len2 > size) {
+            len2 = size - len1;
+        }
+    }
+
+    if (len1 > 0) {
+        block_vec.emplace_back(Iovec(mem1, len1));
+    }
+    if (len2 > 0) {
+        block_vec.emplace_back(Iovec(mem2, len2));
+    }
+    return len1 + len2;
+}
+
+uint32_t BufferBlock::GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size) {
+    void* mem1 = nullptr, *mem2 = nullptr;
+    uint32_t len1 = 0, len2 = 0;
+    GetUseMemoryBlock(mem1, len1, mem2, len2);
+
+    if (max_size > 0) {
+        if (len1 >= max_size) {
+            len1 = max_size;
+            len2 = 0;
+
+        } else if (len1 + len2 > max_size) {
+            len2 = max_size - len1;
+        }
+    }
+
+    if (len1 > 0) {
+        block_vec.emplace_back(Iovec(mem1, len1));
+    }
+    if (len2 > 0) {
+        block_vec.emplace_back(Iovec(mem2, len2));
+    }
+    return len1 + len2;
+}
+
+uint32_t BufferBlock::GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len) {
+    void* data1 = nullptr, *data2 = nullptr;
+    uint32_t len1 = 0, len2 = 0;
+    GetUseMemoryBlock(data1, len1, data2, len2);
+
+    if (max_len > 0) {
+        if (len1 >= max_len) {
+            len1 = max_len;
+            len2 = 0;
+
+        } else if (len1 + len2 > max_len) {
+            len2 = max_len - len1;
+        }
+    }
+
+    if (len1 > 0) {
+        spans.push_back(BufferSpan{ (const char*)data1, len1 });
+    }
+    if (len2 > 0) {
+        spans.push_back(BufferSpan{ (const char*)data2, len2 });
+    }
+    return len1 + len2;
+}
+
+uint32_t BufferBlock::Consume(uint32_t len) {
+    uint32_t can_read = GetCanReadLength();
+    if (len > can_read) {
+        len = can_read;
+    }
+    return (uint32_t)MoveReadPt((int32_t)len);
+}
+
 uint32_t BufferBlock::FindStr(const char* s, uint32_t s_len) {
     if (_write > _read) {
-        const char* find = _FindStrInMem(_read, s, uint32_t(_write - _read), s_len);
+        const char* find = FindStrInMem(_read, uint32_t(_write - _read), s, s_len);
         if (find) {
             return (uint32_t)(find - _read + s_len);
         }
         return 0;
         
     } else if (_write < _read) {
-        const char* find = _FindStrInMem(_read, s, uint32_t(_buffer_end - _read), s_len);
+        const char* find = FindStrInMem(_read, uint32_t(_buffer_end - _read), s, s_len);
         if (find) {
             return uint32_t(find - _read + s_len);
         }
-        find = _FindStrInMem(_buffer_start, s, uint32_t(_write - _buffer_start), s_len);
+        find = FindStrInMem(_buffer_start, uint32_t(_write - _buffer_start), s, s_len);
         if (find) {
             return uint32_t(find - _buffer_start + s_len + _buffer_end - _read);
         }
@@ -451,11 +584,11 @@ uint32_t BufferBlock::FindStr(const char* s, uint32_t s_len) {
 
     } else {
         if (_can_read) {
-            const char* find = _FindStrInMem(_read, s, uint32_t(_buffer_end - _read), s_len);
+            const char* find = FindStrInMem(_read, uint32_t(_buffer_end - _read), s, s_len);
             if (find) {
                 return uint32_t(find - _read + s_len);
             }
-            find = _FindStrInMem(_buffer_start, s, uint32_t(_write - _buffer_start), s_len);
+            find = FindStrInMem(_buffer_start, uint32_t(_write - _buffer_start), s, s_len);
             if (find) {
                 return uint32_t(find - _buffer_start + s_len + _buffer_end - _read);
             }
@@ -471,33 +604,6 @@ std::shared_ptr<BlockMemoryPool> BufferBlock::GetBlockMemoryPool() {
     return _alloter.lock();
 }
 
-const char* BufferBlock::_FindStrInMem(const char* buffer, const char* ch, uint32_t buffer_len, uint32_t ch_len) const {
-    if (!buffer) {
-        return nullptr;
-    }
-
-    const char* buffer_end = buffer + buffer_len;
-    const char* buff = buffer;
-    const char* find = nullptr;
-    size_t finded = 0;
-    while(true) {
-        find = (char*)memchr(buff, *ch, buffer_len - finded);
-        if (!find || find > buffer_end - ch_len) {
-            break;
-        }
-        
-        if (memcmp(find, ch, ch_len) == 0) {
-            return find;
-        }
-        finded += find - buff + 1;
-        if (buffer_len - finded < ch_len) {
-            break;
-        }
-        buff = ++find;
-    }
-    return nullptr;
-}
-    
 uint32_t BufferBlock::_Read(char* res, uint32_t len, bool move_pt) {
     /*s-----------r-----w-------------e*/
     if (_read < _write) {
@@ -12,13 +12,24 @@
 
 namespace cppnet {
 
+class AlloterWrap;
 class BlockMemoryPool;
+// a ring buffer on one block of memory pool.
+// a block can be shared by other blocks as read only slices, so
+// data can be moved between buffers without copy. memory is
+// writable again after all slices are released. slices must be
+// released in the thread of origin block.
 class BufferBlock: 
     public InnerBuffer, 
     public ListSlot<BufferBlock> {
 
 public:
-    BufferBlock(std::shared_ptr<BlockMemoryPool>& alloter);
+    // size: expected size, decides size class of memory
+    BufferBlock(std::shared_ptr<BlockMemoryPool>& alloter, uint32_t size = 0);
+    // slice of the first len readable bytes of origin.
+    // alloter is the one origin was created by.
+    BufferBlock(std::shared_ptr<BufferBlock> origin, uint32_t len,
+        std::shared_ptr<AlloterWrap> alloter);
     ~BufferBlock();
 
     // read to res buf but don't change the read point
@@ -64,15 +75,28 @@ public:
     // there may be two blocks
     bool GetUseMemoryBlock(void*& res1, uint32_t& len1, void*& res2, uint32_t& len2);
 
+    // same as above, block never grows. at most size bytes, 0 means no limit
+    uint32_t GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t size = 0);
+    uint32_t GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size = 0);
+
     // return can read bytes
     uint32_t FindStr(const char* s, uint32_t s_len);
 
+    // at most two spans, the block is a ring
+    uint32_t GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len = 0);
+    uint32_t Consume(uint32_t len);
+
+    // block is one piece of memory, nothing to do
+    void Shrink() {}
+
     // return block memory pool
     std::shared_ptr<BlockMemoryPool> GetBlockMemoryPool();
 
+    // memory is referenced by a slice or the block is a slice.
+    // shared block can't be written.
+    bool IsShared() { return _origin || _share_count > 0; }
+
 private:
-    //find str in fix length buffer. return the first position if find otherwise return nullptr
-    const char* _FindStrInMem(const char* buffer, const char* ch, uint32_t buffer_len, uint32_t ch_len) const;
     uint32_t _Read(char* res, uint32_t len, bool move_pt);
     uint32_t _Write(const char* data, uint32_t len);
 
@@ -83,7 +107,13 @@ private:
     char*    _buffer_start;
     char*    _buffer_end;
     bool     _can_read;         //when _read == _write? Is there any data can be read.
+    uint32_t _share_count;      //slices of the block, slices live in the dispatcher of the block
     std::weak_ptr<BlockMemoryPool> _alloter;
+
+    // keep memory of a slice alive, origin must be released first
+    std::shared_ptr<AlloterWrap>     _origin_alloter;
+    std::shared_ptr<BlockMemoryPool> _origin_pool;
+    std::shared_ptr<BufferBlock>     _origin;
 };
 }
 
@@ -6,8 +6,10 @@
 #ifndef COMMON_BUFFER_BUFFER_INTERFACE
 #define COMMON_BUFFER_BUFFER_INTERFACE
 
+#include <vector>
 #include <memory>
 #include "include/cppnet_buffer.h"
+#include "common/network/io_handle.h"
 
 namespace cppnet {
 
@@ -53,6 +55,21 @@ public:
     // move write point
     virtual int32_t MoveWritePt(int32_t len) = 0;
 
+    virtual uint32_t GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len = 0) = 0;
+    virtual uint32_t Consume(uint32_t len) = 0;
+
+    // get free memory block to read from socket.
+    // try to get at least size bytes, 0 means existing free memory.
+    // return size of free memory.
+    virtual uint32_t GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t size = 0) = 0;
+    // get used memory block to write to socket.
+    // return size of use memory, not more than max_size, 0 means all.
+    virtual uint32_t GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size = 0) = 0;
+
+    // give memory back when connection is idle. all memory
+    // if there is no data, otherwise free memory after data.
+    virtual void Shrink() = 0;
+
     // return block memory pool
     virtual std::shared_ptr<BlockMemoryPool> GetBlockMemoryPool() = 0;
 };
@@ -3,6 +3,9 @@
 
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
+#include <cstring>
+#include <algorithm>
+#include "common/util/find_str.h"
 #include "common/alloter/pool_block.h"
 #include "common/buffer/buffer_queue.h"
 #include "common/buffer/buffer_block.h"
@@ -15,6 +18,7 @@ static const uint8_t __block_vec_default_size = 8;
 BufferQueue::BufferQueue(const std::shared_ptr<BlockMemoryPool>& block_pool, 
     const std::shared_ptr<AlloterWrap>& alloter):
     _can_read_length(0),
+    _find_checked(0),
     _block_alloter(block_pool),
     _alloter(alloter) {
 
@@ -45,124 +49,49 @@ uint32_t BufferQueue::Read(std::shared_ptr<InnerBuffer> buffer, uint32_t len) {
     if (!buffer) {
         return 0;
     }
-    
-    if (len == 0) {
-        len = GetCanReadLength();
-    } 
-    if (len == 0) {
-        return 0;
-    }
 
+    // share only within a dispatcher, block pool and share count of
+    // a block are not thread safe
     std::shared_ptr<BufferQueue> buffer_queue = std::dynamic_pointer_cast<BufferQueue>(buffer);
-    if (!buffer_queue->_buffer_write) {
-        buffer_queue->Append();
-        buffer_queue->_buffer_write = buffer_queue->_buffer_list.GetTail();
+    if (buffer_queue && buffer_queue->_block_alloter == _block_alloter) {
+        return buffer_queue->ShareFrom(*this, len);
     }
 
-    uint32_t can_write_size = buffer_queue->_buffer_write->GetCanWriteLength();
-    uint32_t total_read_len = 0;
-    uint32_t cur_read_len = 0;
-
-    auto buffer_read = _buffer_list.GetHead();
-    while (buffer_read) {
-        cur_read_len = buffer_read->Read(buffer_queue->_buffer_write, can_write_size);
-        total_read_len += cur_read_len;
-
-        // current write block is full
-        if (cur_read_len >= can_write_size) {
-            if (total_read_len >= len) {
-                break;
-            }
-
-            buffer_queue->Append();
-            buffer_queue->_buffer_write = buffer_queue->_buffer_list.GetTail();
-            can_write_size = buffer_queue->_buffer_write->GetCanWriteLength();
-
-        // current read block is empty
-        } else {
-            can_write_size -= cur_read_len;
-            if (buffer_read == _buffer_write) {
-                if (_buffer_write->GetNext()) {
-                    _buffer_write = _buffer_write->GetNext();
-
-                } else {
-                    Reset();
-                    break;
-                }
-            }
-            _buffer_list.PopFront();
-            buffer_read = _buffer_list.GetHead();
-        }
-
-        if (total_read_len >= len) {
-            break;
-        }
+    // other buffer or other pool, copy. both buffers must be used in the
+    // calling thread, the pools are not locked
+    std::vector<BufferSpan> spans;
+    GetReadableSpans(spans, len);
+    uint32_t total_len = 0;
+    for (auto& span : spans) {
+        total_len += buffer->Write(span._data, span._len);
     }
-    _can_read_length -= total_read_len;
-    buffer_queue->_can_read_length += total_read_len;
-    return total_read_len;
+    return Consume(total_len);
 }
 
 uint32_t BufferQueue::Write(std::shared_ptr<InnerBuffer> buffer, uint32_t len) {
     if (!buffer) {
         return 0;
     }
-    
-    if (len == 0) {
-        len = buffer->GetCanReadLength();
-    }
-    if (len == 0) {
-        return 0;
-    }
 
     std::shared_ptr<BufferQueue> buffer_queue = std::dynamic_pointer_cast<BufferQueue>(buffer);
-    auto from_list = buffer_queue->_buffer_list;
-    auto from_buffer = from_list.GetHead();
-
-    uint32_t should_write_size = from_list.GetHead()->GetCanReadLength();
-    uint32_t total_write_len = 0;
-    uint32_t cur_write_len = 0;
-
-    while (1) {
-        if (!_buffer_write) {
-            Append();
-            _buffer_write = _buffer_list.GetTail();
-        }
-
-        cur_write_len = _buffer_write->Write(from_buffer, should_write_size);
-        total_write_len += cur_write_len;
-        
-        // current read block is empty
-        if (cur_write_len >= should_write_size) {
-            if (from_buffer == buffer_queue->_buffer_write) {
-                if (buffer_queue->_buffer_write->GetNext()) {
-                    buffer_queue->_buffer_write = buffer_queue->_buffer_write->GetNext();
-
-                } else {
-                    buffer_queue->Reset();
-                    break;
-                }
-            }
-            from_list.PopFront();
-            from_buffer = from_list.GetHead();
-            should_write_size = from_buffer->GetCanReadLength();
-
-        // current write block is full
-        } else {
-            if (total_write_len >= len) {
-                break;
-            }
-            should_write_size -= cur_write_len;
-            _buffer_write = _buffer_write->GetNext();
-        }
+    if (buffer_queue && buffer_queue->_block_alloter == _block_alloter) {
+        return ShareFrom(*buffer_queue, len);
+    }
 
-        if (total_write_len >= len) {
+    // other buffer or other pool, copy. both buffers must be used in the
+    // calling thread, the pools are not locked
+    std::vector<BufferSpan> spans;
+    buffer->GetReadableSpans(spans, len);
+    uint32_t total_len = 0;
+    for (auto& span : spans) {
+        uint32_t ret = Write(span._data, span._len);
+        total_len += ret;
+        // out of memory
+        if (ret < span._len) {
             break;
         }
     }
-    _can_read_length += total_write_len;
-    buffer_queue->_can_read_length -= total_write_len;
-    return total_write_len;
+    return buffer->Consume(total_len);
 }
 
 uint32_t BufferQueue::Read(char* res, uint32_t len) {
@@ -193,6 +122,7 @@ uint32_t BufferQueue::Read(char* res, uint32_t len) {
         }
     }
     _can_read_length -= total_read_len;
+    _find_checked = _find_checked > total_read_len ? _find_checked - total_read_len : 0;
     return total_read_len;
 }
 
@@ -205,7 +135,9 @@ uint32_t BufferQueue::Write(const char* str, uint32_t len) {
 
     while (1) {
         if (!_buffer_write) {
-            Append();
+            if (!Append(len - write_len)) {
+                break;
+            }
             _buffer_write = _buffer_list.GetTail();
         }
 
@@ -234,7 +166,10 @@ int32_t BufferQueue::MoveReadPt(int32_t len) {
             total_read_len += buffer_read->MoveReadPt(len - total_read_len);
 
             if (total_read_len >= len) {
-                break;
+                // give shared memory back as soon as it's read out
+                if (!buffer_read->IsShared() || buffer_read->GetCanReadLength() > 0) {
+                    break;
+                }
             }
 
             if (buffer_read == _buffer_write) {
@@ -248,13 +183,19 @@ int32_t BufferQueue::MoveReadPt(int32_t len) {
             }
             _buffer_list.PopFront();
             buffer_read = _buffer_list.GetHead();
+            if (total_read_len >= len) {
+                break;
+            }
         }
 
     } else {
+        // data is read again, search from start
+        _find_checked = 0;
         total_read_len += buffer_read->MoveReadPt(len);
     }
 
     _can_read_length -= total_read_len;
+    _find_checked = _find_checked > (uint32_t)total_read_len ? _find_checked - total_read_len : 0;
     return total_read_len;
 }
 
@@ -270,6 +211,8 @@ int32_t BufferQueue::MoveWritePt(int32_t len) {
         }
 
     } else {
+        // data may be written again
+        _find_checked = 0;
         while (_buffer_write) {
             total_write_len += _buffer_write->MoveWritePt(len + total_write_len);
             if (_buffer_write == _buffer_list.GetHead() || -len <= total_write_len) {
@@ -338,7 +281,9 @@ uint32_t BufferQueue::GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t
     if (size > 0) {
         while (cur_len < size) {
             if (temp == nullptr) {
-                Append();
+                if (!Append(size - cur_len)) {
+                    break;
+                }
                 temp = _buffer_list.GetTail();
             }
         
@@ -355,12 +300,6 @@ uint32_t BufferQueue::GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t
         }
 
     } else {
-        // add one block
-        if (!temp) {
-            Append();
-            temp = _buffer_list.GetTail();
-        }
-        
         while (temp) {
             temp->GetFreeMemoryBlock(mem_1, mem_len_1, mem_2, mem_len_2);
             if (mem_len_1 > 0) {
@@ -376,6 +315,17 @@ uint32_t BufferQueue::GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t
             }
             temp = temp->GetNext();
         }
+
+        // add one block, if there is no block or the last one is shared
+        if (cur_len == 0) {
+            if (!Append()) {
+                return 0;
+            }
+            temp = _buffer_list.GetTail();
+            temp->GetFreeMemoryBlock(mem_1, mem_len_1, mem_2, mem_len_2);
+            block_vec.emplace_back(Iovec(mem_1, mem_len_1));
+            cur_len += mem_len_1;
+        }
     }
     return cur_len;
 }
@@ -407,49 +357,196 @@ uint32_t BufferQueue::GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t
         }
         temp = temp->GetNext();
     }
+    // cut the last blocks, never return more than max size.
+    // a block may add two pieces, the last one can be shorter than the excess.
+    while (max_size > 0 && cur_len > max_size) {
+        uint32_t over = cur_len - max_size;
+        if (block_vec.back()._iov_len > over) {
+            block_vec.back()._iov_len -= over;
+            cur_len = max_size;
+
+        } else {
+            cur_len -= (uint32_t)block_vec.back()._iov_len;
+            block_vec.pop_back();
+        }
+    }
     return cur_len;
 }
 
 uint32_t BufferQueue::FindStr(const char* s, uint32_t s_len) {
-    if (_buffer_list.Size() == 0) {
+    if (!s || s_len == 0 || _can_read_length < s_len) {
         return 0;
     }
 
+    if (_find_str.length() != s_len || memcmp(_find_str.data(), s, s_len) != 0) {
+        _find_str.assign(s, s_len);
+        _find_checked = 0;
+    }
+
+    // last s_len - 1 bytes of searched memory, to find s across two memory
+    std::string carry;
+    uint32_t offset = 0;
+    void* mem[2] = { nullptr, nullptr };
+    uint32_t mem_len[2] = { 0, 0 };
+
     std::shared_ptr<BufferBlock> temp = _buffer_list.GetHead();
-    uint32_t cur_len = 0;
-    uint32_t can_read = 0;
     while (temp) {
-        can_read = temp->FindStr(s, s_len);
-        if (can_read > 0) {
-            cur_len += can_read;
+        temp->GetUseMemoryBlock(mem[0], mem_len[0], mem[1], mem_len[1]);
+        for (uint32_t i = 0; i < 2; i++) {
+            const char* data = (const char*)mem[i];
+            uint32_t len = mem_len[i];
+            // skip searched memory
+            if (offset + len <= _find_checked) {
+                offset += len;
+                continue;
+            }
+            if (offset < _find_checked) {
+                data += _find_checked - offset;
+                len -= _find_checked - offset;
+                offset = _find_checked;
+            }
+
+            if (!carry.empty()) {
+                uint32_t carry_len = (uint32_t)carry.length();
+                carry.append(data, std::min(len, s_len - 1));
+                const char* find = FindStrInMem(carry.data(), (uint32_t)carry.length(), s, s_len);
+                if (find) {
+                    _find_checked = offset - carry_len + (uint32_t)(find - carry.data());
+                    return _find_checked + s_len;
+                }
+                carry.resize(carry_len);
+            }
+
+            const char* find = FindStrInMem(data, len, s, s_len);
+            if (find) {
+                _find_checked = offset + (uint32_t)(find - data);
+                return _find_checked + s_len;
+            }
+
+            if (len >= s_len - 1) {
+                carry.assign(data + len - (s_len - 1), s_len - 1);
+
+            } else {
+                carry.append(data, len);
+                if (carry.length() >= s_len) {
+                    carry.erase(0, carry.length() - (s_len - 1));
+                }
+            }
+            offset += len;
+        }
+
+        if (temp == _buffer_write) {
             break;
         }
+        temp = temp->GetNext();
+    }
+    // not found, next search starts from the last s_len - 1 bytes
+    _find_checked = _can_read_length - s_len + 1;
+    return 0;
+}
+
+uint32_t BufferQueue::GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len) {
+    std::shared_ptr<BufferBlock> temp = _buffer_list.GetHead();
+    uint32_t cur_len = 0;
+    while (temp) {
+        cur_len += temp->GetReadableSpans(spans, max_len > 0 ? max_len - cur_len : 0);
         if (temp == _buffer_write) {
             break;
         }
-        cur_len += temp->GetCanReadLength();
+        if (max_len > 0 && cur_len >= max_len) {
+            break;
+        }
         temp = temp->GetNext();
     }
     return cur_len;
 }
 
+uint32_t BufferQueue::Consume(uint32_t len) {
+    if (len > _can_read_length) {
+        len = _can_read_length;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    return (uint32_t)MoveReadPt((int32_t)len);
+}
+
+void BufferQueue::Shrink() {
+    if (_can_read_length == 0) {
+        Reset();
+        return;
+    }
+    // free blocks after write block
+    while (_buffer_write && _buffer_list.GetTail() != _buffer_write) {
+        _buffer_list.PopBack();
+    }
+}
+
 std::shared_ptr<BlockMemoryPool> BufferQueue::GetBlockMemoryPool() {
     return _block_alloter;
 }
 
 void BufferQueue::Reset() {
+    _find_checked = 0;
     _buffer_list.Clear();
     _buffer_write.reset();
 }
 
-void BufferQueue::Append() {
-    auto temp = _alloter->PoolNewSharePtr<BufferBlock>(_block_alloter);
+uint32_t BufferQueue::ShareFrom(BufferQueue& from, uint32_t len) {
+    if (&from == this) {
+        return 0;
+    }
+    if (len == 0 || len > from._can_read_length) {
+        len = from._can_read_length;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    // free blocks after write block are dropped, slices are appended after it
+    while (_buffer_write && _buffer_list.GetTail() != _buffer_write) {
+        _buffer_list.PopBack();
+    }
+
+    uint32_t total_len = 0;
+    auto temp = from._buffer_list.GetHead();
+    while (temp && total_len < len) {
+        uint32_t cur_len = temp->GetCanReadLength();
+        if (cur_len > len - total_len) {
+            cur_len = len - total_len;
+        }
+
+        if (cur_len > 0) {
+            auto slice = _alloter->PoolNewSharePtr<BufferBlock>(temp, cur_len, from._alloter);
+            _buffer_list.PushBack(slice);
+            _buffer_write = slice;
+            total_len += cur_len;
+        }
+
+        if (temp == from._buffer_write) {
+            break;
+        }
+        temp = temp->GetNext();
+    }
+
+    from.MoveReadPt(total_len);
+    _can_read_length += total_len;
+    return total_len;
+}
+
+bool BufferQueue::Append(uint32_t size) {
+    auto temp = _alloter->PoolNewSharePtr<BufferBlock>(_block_alloter, size);
+    // no memory of block
+    if (temp->GetCanWriteLength() == 0) {
+        return false;
+    }
 
     if (!_buffer_write) {
         _buffer_write = temp;
     }
     
     _buffer_list.PushBack(temp);
+    return true;
 }
 
 }
\ No newline at end of file
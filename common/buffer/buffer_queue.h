@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include "common/structure/list.h"
 #include "common/network/io_handle.h"
 #include "common/buffer/buffer_interface.h"
@@ -29,6 +30,8 @@ public:
     // return read size
     virtual uint32_t ReadNotMovePt(char* res, uint32_t len);
 
+    // move data between two queues, blocks are shared, no copy.
+    // both queues must be used in one thread.
     virtual uint32_t Read(std::shared_ptr<InnerBuffer> buffer, uint32_t len = 0);
     virtual uint32_t Write(std::shared_ptr<InnerBuffer> buffer, uint32_t len = 0);
 
@@ -65,23 +68,41 @@ public:
 
     // get use memory block, 
     // block_vec: memory block vector.
-    // return size of use memory. 
+    // return size of use memory, not more than max_size.
     // if size = 0, return all used memory block. 
     virtual uint32_t GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size = 0);
 
     // return can read bytes
+    // s may cross blocks. searching the same s again starts
+    // from where the last search stopped, until data is read.
     virtual uint32_t FindStr(const char* s, uint32_t s_len);
 
+    // spans point to memory of blocks, no copy
+    virtual uint32_t GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len = 0);
+    virtual uint32_t Consume(uint32_t len);
+
+    // blocks go back to block memory pool
+    virtual void Shrink();
+
     // return block memory pool
     virtual std::shared_ptr<BlockMemoryPool> GetBlockMemoryPool();
 
 protected:
     virtual void Reset();
-    virtual void Append();
+    // size: expected size of data, decides size class of the block.
+    // return false if out of memory
+    virtual bool Append(uint32_t size = 0);
+
+    // move len bytes of from to the tail of data by slices
+    uint32_t ShareFrom(BufferQueue& from, uint32_t len);
 
 protected:
     uint32_t _can_read_length;
 
+    // positions before this can't be start of _find_str
+    uint32_t    _find_checked;
+    std::string _find_str;
+
     List<BufferBlock> _buffer_list;
     std::shared_ptr<BufferBlock> _buffer_write;
     
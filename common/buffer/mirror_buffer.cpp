@@ -0,0 +1,351 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef __win__
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "common/log/log.h"
+#include "common/util/find_str.h"
+#include "common/buffer/mirror_buffer.h"
+
+namespace cppnet {
+
+MirrorBuffer::MirrorBuffer():
+    _buffer(nullptr),
+    _capacity(0),
+    _read(0),
+    _length(0),
+    _find_checked(0) {
+
+}
+
+MirrorBuffer::~MirrorBuffer() {
+    if (_buffer) {
+        Unmap(_buffer, _capacity);
+    }
+}
+
+bool MirrorBuffer::Init(uint32_t size) {
+    if (_buffer) {
+        return false;
+    }
+#ifdef __win__
+    (void)size;
+    return false;
+#else
+    uint32_t page_size = (uint32_t)sysconf(_SC_PAGESIZE);
+    if (size == 0) {
+        size = page_size;
+    }
+    size = (size + page_size - 1) / page_size * page_size;
+
+    _buffer = Map(size);
+    if (!_buffer) {
+        return false;
+    }
+    _capacity = size;
+    return true;
+#endif
+}
+
+uint32_t MirrorBuffer::ReadNotMovePt(char* res, uint32_t len) {
+    if (!res) {
+        return 0;
+    }
+    len = std::min(len, _length);
+    if (len > 0) {
+        memcpy(res, GetReadPt(), len);
+    }
+    return len;
+}
+
+uint32_t MirrorBuffer::Read(std::shared_ptr<InnerBuffer> buffer, uint32_t len) {
+    if (!buffer) {
+        return 0;
+    }
+    if (len == 0 || len > _length) {
+        len = _length;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    return (uint32_t)MoveReadPt((int32_t)buffer->Write(GetReadPt(), len));
+}
+
+uint32_t MirrorBuffer::Write(std::shared_ptr<InnerBuffer> buffer, uint32_t len) {
+    if (!buffer) {
+        return 0;
+    }
+
+    std::vector<BufferSpan> spans;
+    buffer->GetReadableSpans(spans, len);
+    uint32_t total_len = 0;
+    for (auto& span : spans) {
+        total_len += Write(span._data, span._len);
+    }
+    return buffer->Consume(total_len);
+}
+
+uint32_t MirrorBuffer::Read(char* res, uint32_t len) {
+    len = ReadNotMovePt(res, len);
+    if (len == 0) {
+        return 0;
+    }
+    return (uint32_t)MoveReadPt((int32_t)len);
+}
+
+uint32_t MirrorBuffer::Write(const char* data, uint32_t len) {
+    if (!data || len == 0) {
+        return 0;
+    }
+
+    if (_capacity - _length < len) {
+        Expand(len);
+    }
+    len = std::min(len, _capacity - _length);
+    memcpy(GetWritePt(), data, len);
+    _length += len;
+    return len;
+}
+
+void MirrorBuffer::Clear() {
+    _read = 0;
+    _length = 0;
+    _find_checked = 0;
+}
+
+int32_t MirrorBuffer::MoveReadPt(int32_t len) {
+    if (_capacity == 0) {
+        return 0;
+    }
+
+    if (len >= 0) {
+        uint32_t size = std::min((uint32_t)len, _length);
+        _read = (_read + size) % _capacity;
+        _length -= size;
+        _find_checked = _find_checked > size ? _find_checked - size : 0;
+        return (int32_t)size;
+    }
+
+    // data is read again, search from start
+    uint32_t size = std::min((uint32_t)-len, _capacity - _length);
+    _read = (_read + _capacity - size) % _capacity;
+    _length += size;
+    _find_checked = 0;
+    return -(int32_t)size;
+}
+
+int32_t MirrorBuffer::MoveWritePt(int32_t len) {
+    if (len >= 0) {
+        uint32_t size = std::min((uint32_t)len, _capacity - _length);
+        _length += size;
+        return (int32_t)size;
+    }
+
+    // data may be written again
+    uint32_t size = std::min((uint32_t)-len, _length);
+    _length -= size;
+    _find_checked = 0;
+    return -(int32_t)size;
+}
+
+uint32_t MirrorBuffer::ReadUntil(char* res, uint32_t len) {
+    if (_length < len) {
+        return 0;
+    }
+    return Read(res, len);
+}
+
+uint32_t MirrorBuffer::ReadUntil(char* res, uint32_t len, const char* find, uint32_t find_len, uint32_t& need_len) {
+    uint32_t size = FindStr(find, find_len);
+    if (size) {
+        if (size <= len) {
+            return Read(res, size);
+
+        } else {
+            need_len = size;
+            return 0;
+        }
+    }
+    return 0;
+}
+
+uint32_t MirrorBuffer::GetCanWriteLength() {
+    return _capacity - _length;
+}
+
+uint32_t MirrorBuffer::GetCanReadLength() {
+    return _length;
+}
+
+uint32_t MirrorBuffer::GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t size) {
+    if (_capacity - _length < size) {
+        Expand(size);
+
+    // buffer is full, make more room like a new block
+    } else if (size == 0 && _capacity == _length) {
+        Expand(_capacity);
+    }
+
+    uint32_t free_len = _capacity - _length;
+    if (free_len > 0) {
+        block_vec.emplace_back(Iovec(GetWritePt(), free_len));
+    }
+    return free_len;
+}
+
+uint32_t MirrorBuffer::GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size) {
+    uint32_t use_len = _length;
+    if (max_size > 0 && use_len > max_size) {
+        use_len = max_size;
+    }
+    if (use_len > 0) {
+        block_vec.emplace_back(Iovec(_buffer + _read, use_len));
+    }
+    return use_len;
+}
+
+uint32_t MirrorBuffer::FindStr(const char* s, uint32_t s_len) {
+    if (!s || s_len == 0 || _length < s_len) {
+        return 0;
+    }
+
+    if (_find_str.length() != s_len || memcmp(_find_str.data(), s, s_len) != 0) {
+        _find_str.assign(s, s_len);
+        _find_checked = 0;
+    }
+
+    const char* data = GetReadPt();
+    const char* find = FindStrInMem(data + _find_checked, _length - _find_checked, s, s_len);
+    if (find) {
+        _find_checked = (uint32_t)(find - data);
+        return _find_checked + s_len;
+    }
+
+    // not found, next search starts from the last s_len - 1 bytes
+    _find_checked = _length - s_len + 1;
+    return 0;
+}
+
+uint32_t MirrorBuffer::GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len) {
+    uint32_t len = _length;
+    if (max_len > 0 && len > max_len) {
+        len = max_len;
+    }
+    if (len > 0) {
+        spans.push_back(BufferSpan{ GetReadPt(), len });
+    }
+    return len;
+}
+
+uint32_t MirrorBuffer::Consume(uint32_t len) {
+    return (uint32_t)MoveReadPt((int32_t)std::min(len, _length));
+}
+
+std::shared_ptr<BlockMemoryPool> MirrorBuffer::GetBlockMemoryPool() {
+    return nullptr;
+}
+
+bool MirrorBuffer::Expand(uint32_t need) {
+    if (_capacity == 0) {
+        return false;
+    }
+
+    uint64_t size = _capacity;
+    while (size - _length < need) {
+        size *= 2;
+    }
+    if (size > 0x7FFFFFFF) {
+        LOG_ERROR("mirror buffer is too large. size:%llu", (unsigned long long)size);
+        return false;
+    }
+
+    char* buffer = Map((uint32_t)size);
+    if (!buffer) {
+        return false;
+    }
+
+    memcpy(buffer, GetReadPt(), _length);
+    Unmap(_buffer, _capacity);
+    _buffer = buffer;
+    _capacity = (uint32_t)size;
+    _read = 0;
+    return true;
+}
+
+char* MirrorBuffer::Map(uint32_t size) {
+#ifdef __win__
+    (void)size;
+    return nullptr;
+#else
+#ifdef __linux__
+    int fd = memfd_create("cppnet_mirror", MFD_CLOEXEC);
+#else
+    // name is removed at once, only the fd is used
+    char name[64];
+    snprintf(name, sizeof(name), "/cppnet_mirror_%d_%p", (int)getpid(), (void*)&name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name);
+    }
+#endif
+    if (fd < 0) {
+        LOG_ERROR("create shared memory failed. errno:%d", errno);
+        return nullptr;
+    }
+
+    if (ftruncate(fd, size) != 0) {
+        LOG_ERROR("resize shared memory failed. size:%u, errno:%d", size, errno);
+        close(fd);
+        return nullptr;
+    }
+
+    // reserve continuous address space, then map the memory twice on it
+    char* buffer = (char*)mmap(nullptr, (size_t)size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) {
+        LOG_ERROR("reserve address space failed. size:%u, errno:%d", size * 2, errno);
+        close(fd);
+        return nullptr;
+    }
+
+    if (mmap(buffer, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+        || mmap(buffer + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        LOG_ERROR("map shared memory failed. size:%u, errno:%d", size, errno);
+        munmap(buffer, (size_t)size * 2);
+        close(fd);
+        return nullptr;
+    }
+
+    // mappings keep the memory alive
+    close(fd);
+    return buffer;
+#endif
+}
+
+void MirrorBuffer::Unmap(char* buffer, uint32_t size) {
+#ifdef __win__
+    (void)buffer;
+    (void)size;
+#else
+    munmap(buffer, (size_t)size * 2);
+#endif
+}
+
+std::shared_ptr<MirrorBuffer> MakeMirrorBuffer(uint32_t size) {
+    auto buffer = std::make_shared<MirrorBuffer>();
+    if (!buffer->Init(size)) {
+        return nullptr;
+    }
+    return buffer;
+}
+
+}
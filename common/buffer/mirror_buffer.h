@@ -0,0 +1,108 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_BUFFER_MIRROR_BUFFER
+#define COMMON_BUFFER_MIRROR_BUFFER
+
+#include <string>
+#include <memory>
+#include "common/buffer/buffer_interface.h"
+
+namespace cppnet {
+
+// a ring buffer on shared memory mapped twice back to back, the
+// second mapping follows the end of the first one. so readable data
+// and free memory are always continuous in virtual memory, parsers
+// get one span and readv/writev get one iovec.
+// memory grows by doubling when more is needed.
+// not supported on windows, Init returns false.
+class MirrorBuffer:
+    public InnerBuffer {
+
+public:
+    MirrorBuffer();
+    virtual ~MirrorBuffer();
+
+    // size is rounded up to page size
+    bool Init(uint32_t size);
+
+    // read to res buf but don't change the read point
+    // return read size
+    virtual uint32_t ReadNotMovePt(char* res, uint32_t len);
+
+    // copy data between buffers
+    virtual uint32_t Read(std::shared_ptr<InnerBuffer> buffer, uint32_t len = 0);
+    virtual uint32_t Write(std::shared_ptr<InnerBuffer> buffer, uint32_t len = 0);
+
+    virtual uint32_t Read(char* res, uint32_t len);
+    virtual uint32_t Write(const char* data, uint32_t len);
+    
+    // clear all data
+    virtual void Clear();
+
+    // move read point
+    virtual int32_t MoveReadPt(int32_t len);
+    // move write point
+    virtual int32_t MoveWritePt(int32_t len);
+
+    // do not read when buffer less than len. 
+    // return len when read otherwise return 0
+    virtual uint32_t ReadUntil(char* res, uint32_t len);
+    
+    // do not read when can't find specified character.
+    // return read bytes when read otherwise return 0
+    // when find specified character but res length is too short, 
+    // return 0 and the last param return need length
+    virtual uint32_t ReadUntil(char* res, uint32_t len, const char* find, uint32_t find_len, uint32_t& need_len);
+    
+    virtual uint32_t GetCanWriteLength();
+    virtual uint32_t GetCanReadLength();
+
+    // memory grows if size is more than free memory
+    virtual uint32_t GetFreeMemoryBlock(std::vector<Iovec>& block_vec, uint32_t size = 0);
+    virtual uint32_t GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size = 0);
+
+    // return can read bytes
+    // searching the same s again starts from where the last search stopped
+    virtual uint32_t FindStr(const char* s, uint32_t s_len);
+
+    // always one span
+    virtual uint32_t GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len = 0);
+    virtual uint32_t Consume(uint32_t len);
+
+    // mapping is kept, nothing to do
+    virtual void Shrink() {}
+
+    // not from block memory pool, return nullptr
+    virtual std::shared_ptr<BlockMemoryPool> GetBlockMemoryPool();
+
+    // readable data is continuous from here
+    const char* GetReadPt() { return _buffer + _read; }
+
+private:
+    // make at least need bytes free
+    bool Expand(uint32_t need);
+    char* GetWritePt() { return _buffer + (_read + _length) % _capacity; }
+
+    static char* Map(uint32_t size);
+    static void Unmap(char* buffer, uint32_t size);
+
+private:
+    char*    _buffer;
+    uint32_t _capacity;     //size of one mapping
+    uint32_t _read;         //read offset, less than capacity
+    uint32_t _length;       //readable bytes
+
+    // positions before this can't be start of _find_str
+    uint32_t    _find_checked;
+    std::string _find_str;
+};
+
+// return nullptr if shared memory can't be mapped
+std::shared_ptr<MirrorBuffer> MakeMirrorBuffer(uint32_t size);
+
+}
+
+#endif
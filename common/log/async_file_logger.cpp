@@ -0,0 +1,367 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <chrono>
+#include <cstring>
+#include "common/util/time.h"
+#include "common/log/log_ring.h"
+#include "common/log/binary_log.h"
+#include "common/log/async_file_logger.h"
+
+namespace cppnet {
+
+// size of one write to file
+static const uint32_t __log_batch_size = 1024 * 256;
+// writer thread checks rings at least once in this time
+static const uint32_t __log_flush_interval_ms = 10;
+
+static std::atomic<uint64_t> __logger_id(0);
+
+// ring of current thread, closed when the thread exits
+struct LogRingHolder {
+    uint64_t _logger_id;
+    std::shared_ptr<LogRing> _ring;
+
+    LogRingHolder(): _logger_id(0) {}
+    ~LogRingHolder() {
+        if (_ring) {
+            _ring->Close();
+        }
+    }
+};
+static thread_local LogRingHolder __ring_holder;
+
+AsyncFileLogger::AsyncFileLogger(const std::string& file,
+    FileLoggerSpiltUnit unit,
+    uint16_t max_store_days,
+    uint16_t time_offset,
+    uint32_t ring_size,
+    LogFullPolicy policy,
+    bool binary_file):
+    _id(++__logger_id),
+    _ring_size(ring_size),
+    _policy(policy),
+    _drop_num(0),
+    _drop_reported(0),
+    _batch(__log_batch_size),
+    _batch_len(0),
+    _binary_file(binary_file),
+    _print_stdout(false),
+    _format_buf(__binary_log_text_size),
+    _file_name(file),
+    _file(nullptr),
+    _period_start(0),
+    _period_end(0),
+    _spilt_unit(unit) {
+
+    // logs carry their time, offset isn't needed
+    (void)time_offset;
+    if (unit == FLSU_HOUR) {
+        _max_file_num = max_store_days * 24;
+
+    } else {
+        _max_file_num = max_store_days;
+    }
+
+    Start();
+}
+
+AsyncFileLogger::~AsyncFileLogger() {
+    Stop();
+    Join();
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+void AsyncFileLogger::Run() {
+    while (true) {
+        // logs pushed before stop are written
+        bool stop = _stop;
+        uint32_t len = Drain();
+        if (stop) {
+            break;
+        }
+
+        if (len == 0) {
+            std::unique_lock<std::mutex> lock(_wait_mutex);
+            _wait_cond.wait_for(lock, std::chrono::milliseconds(__log_flush_interval_ms));
+        }
+    }
+}
+
+void AsyncFileLogger::Stop() {
+    _stop = true;
+    _wait_cond.notify_one();
+}
+
+void AsyncFileLogger::Debug(std::shared_ptr<Log>& log) {
+    Push(log, false);
+    Logger::Debug(log);
+}
+
+void AsyncFileLogger::Info(std::shared_ptr<Log>& log) {
+    Push(log, false);
+    Logger::Info(log);
+}
+
+void AsyncFileLogger::Warn(std::shared_ptr<Log>& log) {
+    Push(log, false);
+    Logger::Warn(log);
+}
+
+void AsyncFileLogger::Error(std::shared_ptr<Log>& log) {
+    Push(log, true);
+    Logger::Error(log);
+}
+
+void AsyncFileLogger::Fatal(std::shared_ptr<Log>& log) {
+    Push(log, true);
+    Logger::Fatal(log);
+}
+
+void AsyncFileLogger::SetMaxStoreDays(uint16_t max) {
+    if (_spilt_unit == FLSU_HOUR) {
+        _max_file_num = max * 24;
+
+    } else {
+        _max_file_num = max;
+    }
+}
+
+void AsyncFileLogger::Push(std::shared_ptr<Log>& log, bool wakeup) {
+    LogRing* ring = GetRing();
+    while (!ring->Push(log->_log, log->_len, log->_time)) {
+        if (_policy == LFP_DROP || _stop) {
+            _drop_num.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        _wait_cond.notify_one();
+        std::this_thread::yield();
+    }
+
+    // don't wake up writer thread for every log, it drains rings every few milliseconds
+    if (wakeup || ring->Size() >= ring->Capacity() / 2) {
+        _wait_cond.notify_one();
+    }
+}
+
+LogRing* AsyncFileLogger::GetRing() {
+    if (__ring_holder._logger_id == _id) {
+        return __ring_holder._ring.get();
+    }
+
+    // the thread logs first time
+    if (__ring_holder._ring) {
+        __ring_holder._ring->Close();
+    }
+    auto ring = std::make_shared<LogRing>(_ring_size);
+    {
+        std::unique_lock<std::mutex> lock(_ring_mutex);
+        _rings.push_back(ring);
+    }
+    __ring_holder._logger_id = _id;
+    __ring_holder._ring = ring;
+    return ring.get();
+}
+
+uint32_t AsyncFileLogger::Drain() {
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+        std::unique_lock<std::mutex> lock(_ring_mutex);
+        rings = _rings;
+    }
+
+    uint32_t total = 0;
+    bool has_closed = false;
+    for (auto ring = rings.begin(); ring != rings.end(); ring++) {
+        // check close first, logs pushed before close are drained
+        bool closed = (*ring)->IsClosed();
+        has_closed = has_closed || closed;
+
+        uint32_t len = 0;
+        uint64_t time = 0;
+        const char* log = nullptr;
+        while ((log = (*ring)->Front(len, time)) != nullptr) {
+            Append(log, len, time);
+            (*ring)->Pop();
+            total += len;
+        }
+    }
+
+    uint64_t drop_num = _drop_num.load(std::memory_order_relaxed);
+    if (drop_num != _drop_reported) {
+        char log[128];
+        uint64_t time = UTCTimeMsec();
+        uint32_t len = snprintf(log, sizeof(log), "[WAR|");
+        uint32_t size = __format_time_buf_size;
+        GetFormatTime(time, log + len, size);
+        len += size;
+        len += snprintf(log + len, sizeof(log) - len, "|async logger] %llu logs are dropped as ring is full",
+            (unsigned long long)(drop_num - _drop_reported));
+        Append(log, len, time);
+        _drop_reported = drop_num;
+    }
+    Flush();
+    if (_print_stdout) {
+        fflush(stdout);
+    }
+
+    // remove rings of exited threads
+    if (has_closed) {
+        std::unique_lock<std::mutex> lock(_ring_mutex);
+        for (auto ring = _rings.begin(); ring != _rings.end();) {
+            if ((*ring)->IsClosed() && (*ring)->Size() == 0) {
+                ring = _rings.erase(ring);
+
+            } else {
+                ring++;
+            }
+        }
+    }
+    return total;
+}
+
+void AsyncFileLogger::Append(const char* log, uint32_t len, uint64_t time) {
+    bool binary = IsBinaryLog(log, len);
+    if (binary && !_binary_file) {
+        len = FormatBinaryLog(log, len, _format_buf.data(), (uint32_t)_format_buf.size());
+        log = _format_buf.data();
+        binary = false;
+    }
+    if (_print_stdout) {
+        Print(log, len, binary);
+    }
+
+    // the log goes to a new file, write the old ones first.
+    // logs of threads are not in time order, the period only
+    // moves forward and late logs go to the current file
+    if (time >= _period_end) {
+        Flush();
+        CheckTime(time);
+    }
+
+    if (!_binary_file) {
+        AppendBatch(log, len);
+        AppendBatch("\n", 1);
+
+    } else if (binary) {
+        BinaryLogHead head = GetBinaryLogHead(log);
+        DefineString(head._format);
+        DefineString(head._file);
+        AppendRecord(BLFR_BINARY, log, len);
+
+    } else {
+        AppendRecord(BLFR_TEXT, log, len);
+    }
+}
+
+void AsyncFileLogger::Print(const char* log, uint32_t len, bool binary) {
+    // binary log is kept in file, formatted only for stdout
+    if (binary) {
+        len = FormatBinaryLog(log, len, _format_buf.data(), (uint32_t)_format_buf.size());
+        log = _format_buf.data();
+    }
+    fwrite(log, 1, len, stdout);
+    fputc('\n', stdout);
+}
+
+void AsyncFileLogger::AppendRecord(uint8_t type, const void* data, uint32_t len, const void* data2, uint32_t len2) {
+    uint32_t total = len + len2;
+    AppendBatch(&type, sizeof(type));
+    AppendBatch(&total, sizeof(total));
+    AppendBatch(data, len);
+    if (data2) {
+        AppendBatch(data2, len2);
+    }
+}
+
+void AsyncFileLogger::DefineString(uint64_t addr) {
+    if (!_defined_strings.insert(addr).second) {
+        return;
+    }
+    const char* str = (const char*)(uintptr_t)addr;
+    AppendRecord(BLFR_STRING, &addr, sizeof(addr), str, (uint32_t)strlen(str));
+}
+
+void AsyncFileLogger::AppendBatch(const void* data, uint32_t len) {
+    // a record may be in two writes, they go to the same file
+    const char* cur = (const char*)data;
+    while (len > 0) {
+        if (_batch_len == _batch.size()) {
+            Flush();
+        }
+        uint32_t size = (uint32_t)_batch.size() - _batch_len;
+        if (size > len) {
+            size = len;
+        }
+        memcpy(_batch.data() + _batch_len, cur, size);
+        _batch_len += size;
+        cur += size;
+        len -= size;
+    }
+}
+
+void AsyncFileLogger::Flush() {
+    if (_batch_len == 0) {
+        return;
+    }
+    if (_file) {
+        fwrite(_batch.data(), 1, _batch_len, _file);
+    }
+    _batch_len = 0;
+}
+
+void AsyncFileLogger::CheckTime(uint64_t time) {
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+
+    // get new time period and file name
+    FormatTimeUnit unit = _spilt_unit == FLSU_HOUR ? FTU_HOUR : FTU_DAY;
+    GetTimePeriod(time, unit, _period_start, _period_end);
+
+    char time_buf[__file_logger_time_buf_size];
+    uint32_t size = __file_logger_time_buf_size;
+    GetFormatTime(time, time_buf, size, unit);
+    std::string file_name(_file_name);
+    file_name.append(".");
+    file_name.append(time_buf, size);
+    file_name.append(_binary_file ? ".blog" : ".log");
+
+    // don't delete a file which is still in use
+    if (_history_file_names.empty() || _history_file_names.back() != file_name) {
+        _history_file_names.push(file_name);
+        CheckExpireFiles();
+    }
+
+    // open new log file, no stdio buffer, every batch is one write
+    _file = fopen(file_name.c_str(), _binary_file ? "ab" : "a");
+    if (!_file) {
+        return;
+    }
+    setvbuf(_file, nullptr, _IONBF, 0);
+
+    // every binary log file can be decoded alone
+    if (_binary_file) {
+        _defined_strings.clear();
+        if (ftell(_file) == 0) {
+            fwrite(__binary_log_file_magic, 1, sizeof(__binary_log_file_magic) - 1, _file);
+        }
+    }
+}
+
+void AsyncFileLogger::CheckExpireFiles() {
+    // delete expire files
+    while (_history_file_names.size() > _max_file_num) {
+        std::string del_file = _history_file_names.front();
+        _history_file_names.pop();
+        std::remove(del_file.c_str());
+    }
+}
+
+} // namespace cppnet
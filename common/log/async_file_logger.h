@@ -0,0 +1,136 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_LOG_ASYNC_FILE_LOGGER
+#define COMMON_LOG_ASYNC_FILE_LOGGER
+
+#include <mutex>
+#include <queue>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <unordered_set>
+#include <condition_variable>
+
+#include "common/thread/thread.h"
+#include "common/log/file_logger.h"
+#include "common/log/logger_interface.h"
+
+namespace cppnet {
+
+// what to do when ring of the thread is full
+enum LogFullPolicy {
+    LFP_DROP  = 0, // drop the log and count it
+    LFP_BLOCK = 1, // wait the writer thread to make room
+};
+
+// every thread logs to its own ring without lock. one writer thread drains
+// all rings, copies records to a large buffer and writes it to file at once.
+// logs of one thread are in order, logs of different threads may be not.
+// binary logs are formatted by the writer thread, or written to a binary
+// log file when binary_file is set, which is read by the log decoder.
+// the writer thread prints logs to stdout too if it's set.
+class LogRing;
+class AsyncFileLogger:
+    public Logger,
+    public Thread {
+
+public:
+    // time_offset isn't used, logs carry their time. it's kept for old callers.
+    AsyncFileLogger(const std::string& file,
+        FileLoggerSpiltUnit unit = FLSU_DAY,
+        uint16_t max_store_days = 3,
+        uint16_t time_offset = 5,
+        uint32_t ring_size = 1024 * 128,
+        LogFullPolicy policy = LFP_DROP,
+        bool binary_file = false);
+
+    ~AsyncFileLogger();
+
+    void Run();
+    void Stop();
+
+    void Debug(std::shared_ptr<Log>& log);
+    void Info(std::shared_ptr<Log>& log);
+    void Warn(std::shared_ptr<Log>& log);
+    void Error(std::shared_ptr<Log>& log);
+    void Fatal(std::shared_ptr<Log>& log);
+
+    // print logs to stdout in the writer thread, set it before logging
+    void SetPrintStdout(bool print) { _print_stdout = print; }
+    bool GetPrintStdout() { return _print_stdout; }
+
+    void SetFullPolicy(LogFullPolicy policy) { _policy = policy; }
+    LogFullPolicy GetFullPolicy() { return _policy; }
+
+    // logs dropped as ring was full
+    uint64_t GetDropNum() { return _drop_num.load(std::memory_order_relaxed); }
+
+    void SetMaxStoreDays(uint16_t max);
+    uint16_t GetMaxStoreDays() { return _max_file_num; }
+
+private:
+    // copy log to ring of current thread
+    void Push(std::shared_ptr<Log>& log, bool wakeup);
+    LogRing* GetRing();
+    // drain all rings, return the bytes of logs written
+    uint32_t Drain();
+    void Append(const char* log, uint32_t len, uint64_t time);
+    // print log to stdout, binary log is formatted
+    void Print(const char* log, uint32_t len, bool binary);
+    // binary log file record
+    void AppendRecord(uint8_t type, const void* data, uint32_t len, const void* data2 = nullptr, uint32_t len2 = 0);
+    // write format string and file name when they are used first time in the file
+    void DefineString(uint64_t addr);
+    void AppendBatch(const void* data, uint32_t len);
+    void Flush();
+    // open the file of the time period which the log time is in
+    void CheckTime(uint64_t time);
+    void CheckExpireFiles();
+
+private:
+    enum : uint8_t {
+        __file_logger_time_buf_size = sizeof("xxxx-xx-xx:xx")
+    };
+    uint64_t      _id;
+    uint32_t      _ring_size;
+    LogFullPolicy _policy;
+    std::atomic<uint64_t> _drop_num;
+    uint64_t      _drop_reported;
+
+    // rings of all threads, locked only when a thread logs first time
+    std::mutex _ring_mutex;
+    std::vector<std::shared_ptr<LogRing>> _rings;
+
+    // writer thread sleeps here when all rings are empty
+    std::mutex _wait_mutex;
+    std::condition_variable _wait_cond;
+
+    // batch of logs for one write
+    std::vector<char> _batch;
+    uint32_t _batch_len;
+
+    bool _binary_file;
+    bool _print_stdout;
+    std::vector<char> _format_buf;
+    std::unordered_set<uint64_t> _defined_strings;
+
+    std::string _file_name;
+    FILE*       _file;
+
+    // time period of current file in utc milliseconds, checked for every log
+    uint64_t _period_start;
+    uint64_t _period_end;
+    FileLoggerSpiltUnit _spilt_unit;
+
+    // for log file delete
+    uint16_t _max_file_num;
+    std::queue<std::string> _history_file_names;
+};
+
+} // namespace cppnet
+
+#endif
@@ -3,28 +3,41 @@
 
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
+#include <vector>
+
 #include "common/util/time.h"
+#include "common/log/binary_log.h"
 #include "common/log/base_logger.h"
+#include "common/log/flight_recorder.h"
 #include "common/log/logger_interface.h"
 #include "common/alloter/normal_alloter.h"
 
 namespace cppnet {
 
-enum LogLevelMask {
-    LLM_FATAL        = 0x01,
-    LLM_ERROR        = 0x02,
-    LLM_WARN         = 0x04,
-    LLM_INFO         = 0x08,
-    LLM_DEBUG        = 0x10,
+// logs cached by every thread, got and freed without lock.
+// a log freed by other thread goes to the cache of that thread.
+struct LogCache {
+    std::vector<Log*> _logs;
+    std::shared_ptr<Alloter> _allocter;
+
+    ~LogCache() { Clear(); }
+    void Clear() {
+        for (auto log = _logs.begin(); log != _logs.end(); log++) {
+            void* del = (void*)*log;
+            _allocter->Free(del);
+        }
+        _logs.clear();
+    }
 };
+static thread_local LogCache __log_cache;
 
-static uint32_t FormatLog(const char* file, uint32_t line, const char* level, char* buf, uint32_t len) {
+static uint32_t FormatLog(const char* file, uint32_t line, const char* level, uint64_t time, char* buf, uint32_t len) {
     // format level
     uint32_t curlen = snprintf(buf, len, "[%s|", level);
 
     // format time
     uint32_t size = __format_time_buf_size;
-    GetFormatTime(buf + curlen, size);
+    GetFormatTime(time, buf + curlen, size);
     curlen += size;
 
     // format other info
@@ -33,19 +46,29 @@ static uint32_t FormatLog(const char* file, uint32_t line, const char* level, ch
     return curlen;
 }
 
-static uint32_t FormatLog(const char* file, uint32_t line, const char* level, const char* content, va_list list, char* buf, uint32_t len) {
-    uint32_t curlen = 0;
+static void FormatLog(const char* file, uint32_t line, const char* level, Log* log) {
+    log->_time = UTCTimeMsec();
+    log->_len = FormatLog(file, line, level, log->_time, log->_log, log->_len);
+}
+
+static void FormatLog(const char* file, uint32_t line, const char* level, const char* content, va_list list, Log* log) {
+    uint32_t len = log->_len;
 
     // format level time and file name
-    curlen += FormatLog(file, line, level, buf, len);
+    FormatLog(file, line, level, log);
 
-    curlen += vsnprintf(buf + curlen, len - curlen, content, list);
+    log->_len += vsnprintf(log->_log + log->_len, len - log->_len, content, list);
+}
 
-    return curlen;
+static void EncodeLog(uint16_t level, const char* file, uint32_t line, const char* content, va_list list, Log* log) {
+    log->_len = EncodeBinaryLog(level, file, line, content, list, log->_log, log->_len);
+    log->_time = GetBinaryLogHead(log->_log)._time / 1000;
 }
 
 BaseLogger::BaseLogger(uint16_t cache_size, uint16_t block_size):
     _level(LL_INFO),
+    _record_level(LL_NULL),
+    _defer_format(false),
     _cache_size(cache_size),
     _block_size(block_size) {
 
@@ -58,31 +81,45 @@ BaseLogger::~BaseLogger() {
 
 void BaseLogger::SetLevel(LogLevel level) { 
     _level = level; 
-    if (_level > LL_NULL && _cache_queue.Empty()) {
-        for (uint16_t i = 0; i < _cache_size; i++) {
-            _cache_queue.Push(NewLog());
-        }
+    // logs are cached when they are freed, only cache of this thread is reached
+    if (_level == LL_NULL) {
+        __log_cache.Clear();
+    }
+}
 
-    } else if (_level == LL_NULL) {
-        size_t size = _cache_queue.Size();
-        Log* log = nullptr;
-        void* del = nullptr;
-        for (size_t i = 0; i < size; i++) {
-            if (_cache_queue.Pop(log)) {
-                del = (void*)log;
-                _allocter->Free(del);
-            }
-        }
+void BaseLogger::SetRecorder(std::shared_ptr<FlightRecorder> recorder) {
+    if (!recorder) {
+        _record_level = LL_NULL;
     }
+    _recorder = recorder;
+}
+
+void BaseLogger::SetRecordLevel(LogLevel level) {
+    _record_level = _recorder ? level : LL_NULL;
+}
+
+std::string BaseLogger::DumpRecord() {
+    if (!_recorder) {
+        return "";
+    }
+    return _recorder->Dump();
 }
 
 void BaseLogger::Debug(const char* file, uint32_t line, const char* content, va_list list) {
+    if (_record_level & LLM_DEBUG) {
+        _recorder->Record(LL_DEBUG, file, line, content, list);
+    }
     if (!(_level & LLM_DEBUG)) {
         return;
     }
 
     std::shared_ptr<Log> log = GetLog();
-    log->_len = FormatLog(file, line, "DEB", content, list, log->_log, log->_len);
+    if (_defer_format) {
+        EncodeLog(LL_DEBUG, file, line, content, list, log.get());
+
+    } else {
+        FormatLog(file, line, "DEB", content, list, log.get());
+    }
 
     if (_logger) {
         _logger->Debug(log);
@@ -90,12 +127,20 @@ void BaseLogger::Debug(const char* file, uint32_t line, const char* content, va_
 }
 
 void BaseLogger::Info(const char* file, uint32_t line, const char* content, va_list list) {
+    if (_record_level & LLM_INFO) {
+        _recorder->Record(LL_INFO, file, line, content, list);
+    }
     if (!(_level & LLM_INFO)) {
         return;
     }
 
     std::shared_ptr<Log> log = GetLog();
-    log->_len = FormatLog(file, line, "INF", content, list, log->_log, log->_len);
+    if (_defer_format) {
+        EncodeLog(LL_INFO, file, line, content, list, log.get());
+
+    } else {
+        FormatLog(file, line, "INF", content, list, log.get());
+    }
 
     if (_logger) {
         _logger->Info(log);
@@ -103,12 +148,20 @@ void BaseLogger::Info(const char* file, uint32_t line, const char* content, va_l
 }
 
 void BaseLogger::Warn(const char* file, uint32_t line, const char* content, va_list list) {
+    if (_record_level & LLM_WARN) {
+        _recorder->Record(LL_WARN, file, line, content, list);
+    }
     if (!(_level & LLM_WARN)) {
         return;
     }
 
     std::shared_ptr<Log> log = GetLog();
-    log->_len = FormatLog(file, line, "WAR", content, list, log->_log, log->_len);
+    if (_defer_format) {
+        EncodeLog(LL_WARN, file, line, content, list, log.get());
+
+    } else {
+        FormatLog(file, line, "WAR", content, list, log.get());
+    }
 
     if (_logger) {
         _logger->Warn(log);
@@ -116,12 +169,20 @@ void BaseLogger::Warn(const char* file, uint32_t line, const char* content, va_l
 }
 
 void BaseLogger::Error(const char* file, uint32_t line, const char* content, va_list list) {
+    if (_record_level & LLM_ERROR) {
+        _recorder->Record(LL_ERROR, file, line, content, list);
+    }
     if (!(_level & LLM_ERROR)) {
         return;
     }
 
     std::shared_ptr<Log> log = GetLog();
-    log->_len = FormatLog(file, line, "ERR", content, list, log->_log, log->_len);
+    if (_defer_format) {
+        EncodeLog(LL_ERROR, file, line, content, list, log.get());
+
+    } else {
+        FormatLog(file, line, "ERR", content, list, log.get());
+    }
 
     if (_logger) {
         _logger->Error(log);
@@ -129,12 +190,24 @@ void BaseLogger::Error(const char* file, uint32_t line, const char* content, va_
 }
 
 void BaseLogger::Fatal(const char* file, uint32_t line, const char* content, va_list list) {
+    if (_record_level & LLM_FATAL) {
+        _recorder->Record(LL_FATAL, file, line, content, list);
+    }
+    // keep what happened before the fatal error
+    if (_record_level != LL_NULL) {
+        _recorder->Dump();
+    }
     if (!(_level & LLM_FATAL)) {
         return;
     }
 
     std::shared_ptr<Log> log = GetLog();
-    log->_len = FormatLog(file, line, "FAT", content, list, log->_log, log->_len);
+    if (_defer_format) {
+        EncodeLog(LL_FATAL, file, line, content, list, log.get());
+
+    } else {
+        FormatLog(file, line, "FAT", content, list, log.get());
+    }
 
     if (_logger) {
         _logger->Fatal(log);
@@ -155,23 +228,23 @@ LogStreamParam BaseLogger::GetStreamParam(LogLevel level, const char* file, uint
         break;
     case LL_FATAL:
         cb = [this](std::shared_ptr<Log> l) { _logger->Fatal(l); };
-        log->_len = FormatLog(file, line, "FAT", log->_log, log->_len);
+        FormatLog(file, line, "FAT", log.get());
         break;
     case LL_ERROR:
         cb = [this](std::shared_ptr<Log> l) { _logger->Error(l); };
-        log->_len = FormatLog(file, line, "ERR", log->_log, log->_len);
+        FormatLog(file, line, "ERR", log.get());
         break;
     case LL_WARN:
         cb = [this](std::shared_ptr<Log> l) { _logger->Warn(l); };
-        log->_len = FormatLog(file, line, "WAR", log->_log, log->_len);
+        FormatLog(file, line, "WAR", log.get());
         break;
     case LL_INFO:
         cb = [this](std::shared_ptr<Log> l) { _logger->Info(l); };
-        log->_len = FormatLog(file, line, "INF", log->_log, log->_len);
+        FormatLog(file, line, "INF", log.get());
         break;
     case LL_DEBUG:
         cb = [this](std::shared_ptr<Log> l) { _logger->Debug(l); };
-        log->_len = FormatLog(file, line, "DEB", log->_log, log->_len);
+        FormatLog(file, line, "DEB", log.get());
         break;
     default:
         return std::make_pair(nullptr, nullptr);
@@ -182,7 +255,9 @@ LogStreamParam BaseLogger::GetStreamParam(LogLevel level, const char* file, uint
 
 std::shared_ptr<Log> BaseLogger::GetLog() {
     Log* log = nullptr;
-    if (_cache_queue.Pop(log)) {
+    if (!__log_cache._logs.empty()) {
+        log = __log_cache._logs.back();
+        __log_cache._logs.pop_back();
 
     } else {
         log = NewLog();
@@ -194,13 +269,16 @@ std::shared_ptr<Log> BaseLogger::GetLog() {
 }
 
 void BaseLogger::FreeLog(Log* log) {
-    if (_cache_queue.Size() > _cache_size) {
+    if (__log_cache._logs.size() >= _cache_size) {
         void* del = (void*)log;
         _allocter->Free(del);
 
     } else {
+        if (!__log_cache._allocter) {
+            __log_cache._allocter = _allocter;
+        }
         log->_len = _block_size;
-        _cache_queue.Push(log);
+        __log_cache._logs.push_back(log);
     }
 }
 
@@ -8,12 +8,12 @@
 #define COMMON_LOG_BASE_LOGGER_H_
 
 #include <memory>
+#include <string>
 #include <cstdint>
 #include <cstdarg>
 
 #include "common/log/log.h"
 #include "common/log/log_stream.h"
-#include "common/structure/thread_safe_queue.h"
 
 namespace cppnet {
 
@@ -21,6 +21,7 @@ namespace cppnet {
 struct Log;
 class Logger;
 class Alloter;
+class FlightRecorder;
 class BaseLogger {
  public:
   BaseLogger(uint16_t cache_size, uint16_t block_size);
@@ -29,6 +30,15 @@ class BaseLogger {
   void SetLogger(std::shared_ptr<Logger> log) { _logger = log; }
 
   void SetLevel(LogLevel level);
+  uint16_t GetLevel() { return _level; }
+  // logs of record level are kept by flight recorder, stream logs are not.
+  // see flight_recorder.h
+  void SetRecorder(std::shared_ptr<FlightRecorder> recorder);
+  void SetRecordLevel(LogLevel level);
+  uint16_t GetRecordLevel() { return _record_level; }
+  std::string DumpRecord();
+  // keep binary logs, loggers format them later. see binary_log.h
+  void SetDeferFormat(bool defer) { _defer_format = defer; }
 
   void Debug(const char* file, uint32_t line,
     const char* content, va_list list);
@@ -51,12 +61,15 @@ class BaseLogger {
 
  protected:
   uint16_t _level;
+  uint16_t _record_level;
+  bool     _defer_format;
+  // max logs cached by every thread
   uint16_t _cache_size;
   uint16_t _block_size;
 
   std::shared_ptr<Alloter> _allocter;
-  ThreadSafeQueue<Log*>    _cache_queue;
   std::shared_ptr<Logger>  _logger;
+  std::shared_ptr<FlightRecorder> _recorder;
 };
 
 }  // namespace cppnet
@@ -0,0 +1,473 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <cstddef>
+#include <wchar.h>
+
+#include "common/log/log.h"
+#include "common/util/time.h"
+#include "common/log/binary_log.h"
+
+namespace cppnet {
+
+// argument type of a conversion
+enum ArgType {
+    AT_INT,         // 4 bytes
+    AT_LONG,        // 8 bytes, all others too
+    AT_LONG_LONG,
+    AT_INTMAX,
+    AT_SIZE,
+    AT_PTRDIFF,
+    AT_DOUBLE,
+    AT_LONG_DOUBLE,
+    AT_POINTER,
+    AT_STRING,      // 2 bytes length and chars
+    AT_WIDE_STRING, // not kept, printed as empty string
+    AT_COUNT,       // %n, not kept
+};
+
+struct FormatSpec {
+    const char* _end;      // next char after conversion
+    uint8_t     _star_num; // int arguments of '*' width and precision
+    bool        _star_precision;
+    int32_t     _precision; // -1 if not set
+    ArgType     _type;
+};
+
+// parse the conversion starts with '%', return false if it's not supported
+static bool ParseSpec(const char* start, FormatSpec& spec) {
+    const char* p = start + 1;
+    spec._star_num = 0;
+    spec._star_precision = false;
+    spec._precision = -1;
+
+    // flags
+    while (*p && strchr("-+ #0'", *p)) {
+        p++;
+    }
+    // width
+    if (*p == '*') {
+        spec._star_num++;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    // precision
+    if (*p == '.') {
+        p++;
+        spec._precision = 0;
+        if (*p == '*') {
+            spec._star_num++;
+            spec._star_precision = true;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            spec._precision = spec._precision * 10 + (*p - '0');
+            p++;
+        }
+    }
+
+    // length
+    ArgType int_type = AT_INT;
+    bool long_double = false;
+    bool wide = false;
+    switch (*p) {
+    case 'h':
+        p += p[1] == 'h' ? 2 : 1;
+        break;
+    case 'l':
+        if (p[1] == 'l') {
+            int_type = AT_LONG_LONG;
+            p += 2;
+        } else {
+            int_type = AT_LONG;
+            wide = true;
+            p++;
+        }
+        break;
+    case 'q':
+        int_type = AT_LONG_LONG;
+        p++;
+        break;
+    case 'j':
+        int_type = AT_INTMAX;
+        p++;
+        break;
+    case 'z':
+        int_type = AT_SIZE;
+        p++;
+        break;
+    case 't':
+        int_type = AT_PTRDIFF;
+        p++;
+        break;
+    case 'L':
+        long_double = true;
+        p++;
+        break;
+    default:
+        break;
+    }
+
+    // conversion
+    switch (*p) {
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        spec._type = int_type;
+        break;
+    case 'c':
+        // wint_t is promoted to int
+        spec._type = AT_INT;
+        break;
+    case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        spec._type = long_double ? AT_LONG_DOUBLE : AT_DOUBLE;
+        break;
+    case 's':
+        spec._type = wide ? AT_WIDE_STRING : AT_STRING;
+        break;
+    case 'p':
+        spec._type = AT_POINTER;
+        break;
+    case 'n':
+        spec._type = AT_COUNT;
+        break;
+    default:
+        return false;
+    }
+    spec._end = p + 1;
+    return true;
+}
+
+static bool Write(char* buf, uint32_t len, uint32_t& pos, const void* data, uint32_t size) {
+    if (pos + size > len) {
+        return false;
+    }
+    memcpy(buf + pos, data, size);
+    pos += size;
+    return true;
+}
+
+static bool Read(const char*& data, const char* end, void* value, uint32_t size) {
+    if (data + size > end) {
+        return false;
+    }
+    memcpy(value, data, size);
+    data += size;
+    return true;
+}
+
+static bool EncodeArg(const FormatSpec& spec, va_list& list, char* buf, uint32_t len, uint32_t& pos) {
+    int64_t int_value = 0;
+    switch (spec._type) {
+    case AT_INT: {
+        int32_t value = va_arg(list, int);
+        return Write(buf, len, pos, &value, sizeof(value));
+    }
+    case AT_LONG:
+        int_value = (int64_t)va_arg(list, long);
+        break;
+    case AT_LONG_LONG:
+        int_value = (int64_t)va_arg(list, long long);
+        break;
+    case AT_INTMAX:
+        int_value = (int64_t)va_arg(list, intmax_t);
+        break;
+    case AT_SIZE:
+        int_value = (int64_t)va_arg(list, size_t);
+        break;
+    case AT_PTRDIFF:
+        int_value = (int64_t)va_arg(list, ptrdiff_t);
+        break;
+    case AT_DOUBLE: {
+        double value = va_arg(list, double);
+        return Write(buf, len, pos, &value, sizeof(value));
+    }
+    case AT_LONG_DOUBLE: {
+        double value = (double)va_arg(list, long double);
+        return Write(buf, len, pos, &value, sizeof(value));
+    }
+    case AT_POINTER:
+        int_value = (int64_t)(uintptr_t)va_arg(list, void*);
+        break;
+    case AT_STRING: {
+        const char* value = va_arg(list, const char*);
+        if (!value) {
+            value = "(null)";
+        }
+        if (pos + sizeof(uint16_t) > len) {
+            return false;
+        }
+        // the string may not end in precision, don't read over it
+        size_t str_len = spec._precision >= 0 ? strnlen(value, spec._precision) : strlen(value);
+        // cut the string to the left buffer
+        size_t left = len - pos - sizeof(uint16_t);
+        uint16_t size = (uint16_t)(str_len < left ? (str_len < 0xFFFF ? str_len : 0xFFFF) : left);
+        Write(buf, len, pos, &size, sizeof(size));
+        Write(buf, len, pos, value, size);
+        return size == str_len;
+    }
+    case AT_WIDE_STRING:
+        va_arg(list, wchar_t*);
+        return true;
+    case AT_COUNT:
+        va_arg(list, void*);
+        return true;
+    }
+    return Write(buf, len, pos, &int_value, sizeof(int_value));
+}
+
+uint32_t EncodeBinaryLog(uint16_t level, const char* file, uint32_t line,
+    const char* format, va_list list, char* buf, uint32_t len) {
+    BinaryLogHead head;
+    if (len < sizeof(head)) {
+        return 0;
+    }
+    head._flag = __binary_log_flag;
+    head._level = level;
+    head._line = line;
+    head._time = UTCTimeUsec();
+    head._format = (uint64_t)(uintptr_t)format;
+    head._file = (uint64_t)(uintptr_t)file;
+
+    uint32_t pos = 0;
+    Write(buf, len, pos, &head, sizeof(head));
+
+    // keep arguments as the format says, stop when the buffer is full
+    va_list args;
+    va_copy(args, list);
+    const char* p = format;
+    while ((p = strchr(p, '%')) != nullptr) {
+        if (p[1] == '%') {
+            p += 2;
+            continue;
+        }
+
+        FormatSpec spec;
+        if (!ParseSpec(p, spec)) {
+            break;
+        }
+        bool done = true;
+        for (uint8_t i = 0; i < spec._star_num && done; i++) {
+            int32_t star = va_arg(args, int);
+            done = Write(buf, len, pos, &star, sizeof(star));
+            // negative precision is taken as not set
+            if (spec._star_precision && i == spec._star_num - 1) {
+                spec._precision = star < 0 ? -1 : star;
+            }
+        }
+        if (!done || !EncodeArg(spec, args, buf, len, pos)) {
+            break;
+        }
+        p = spec._end;
+    }
+    va_end(args);
+    return pos;
+}
+
+bool IsBinaryLog(const char* log, uint32_t len) {
+    uint16_t flag = 0;
+    if (len < sizeof(BinaryLogHead)) {
+        return false;
+    }
+    memcpy(&flag, log, sizeof(flag));
+    return flag == __binary_log_flag;
+}
+
+BinaryLogHead GetBinaryLogHead(const char* log) {
+    BinaryLogHead head;
+    memcpy(&head, log, sizeof(head));
+    return head;
+}
+
+template<typename T>
+static int FormatArg(char* buf, uint32_t len, const char* spec, int32_t* stars, uint8_t star_num, T value) {
+    switch (star_num) {
+    case 0:
+        return snprintf(buf, len, spec, value);
+    case 1:
+        return snprintf(buf, len, spec, stars[0], value);
+    default:
+        return snprintf(buf, len, spec, stars[0], stars[1], value);
+    }
+}
+
+// format one argument, return false if the data is broken
+static bool DecodeArg(const FormatSpec& spec, const char* spec_str, const char*& data, const char* end,
+    char* buf, uint32_t len, int& ret) {
+    int32_t stars[2] = {0, 0};
+    for (uint8_t i = 0; i < spec._star_num; i++) {
+        if (!Read(data, end, &stars[i], sizeof(int32_t))) {
+            return false;
+        }
+    }
+
+    int64_t int_value = 0;
+    double double_value = 0;
+    switch (spec._type) {
+    case AT_INT: {
+        int32_t value = 0;
+        if (!Read(data, end, &value, sizeof(value))) {
+            return false;
+        }
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (int)value);
+        return true;
+    }
+    case AT_DOUBLE:
+    case AT_LONG_DOUBLE:
+        if (!Read(data, end, &double_value, sizeof(double_value))) {
+            return false;
+        }
+        if (spec._type == AT_DOUBLE) {
+            ret = FormatArg(buf, len, spec_str, stars, spec._star_num, double_value);
+        } else {
+            ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (long double)double_value);
+        }
+        return true;
+    case AT_STRING: {
+        uint16_t size = 0;
+        if (!Read(data, end, &size, sizeof(size)) || data + size > end) {
+            return false;
+        }
+        std::string value(data, size);
+        data += size;
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, value.c_str());
+        return true;
+    }
+    case AT_WIDE_STRING:
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, L"");
+        return true;
+    case AT_COUNT:
+        ret = 0;
+        return true;
+    default:
+        if (!Read(data, end, &int_value, sizeof(int_value))) {
+            return false;
+        }
+        break;
+    }
+
+    switch (spec._type) {
+    case AT_LONG:
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (long)int_value);
+        break;
+    case AT_LONG_LONG:
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (long long)int_value);
+        break;
+    case AT_INTMAX:
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (intmax_t)int_value);
+        break;
+    case AT_SIZE:
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (size_t)int_value);
+        break;
+    case AT_PTRDIFF:
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (ptrdiff_t)int_value);
+        break;
+    default:
+        ret = FormatArg(buf, len, spec_str, stars, spec._star_num, (void*)(uintptr_t)int_value);
+        break;
+    }
+    return true;
+}
+
+static const char* LevelName(uint16_t level) {
+    switch (level) {
+    case LL_FATAL:
+        return "FAT";
+    case LL_ERROR:
+        return "ERR";
+    case LL_WARN:
+        return "WAR";
+    case LL_INFO:
+        return "INF";
+    default:
+        return "DEB";
+    }
+}
+
+uint32_t FormatBinaryLog(const char* log, uint32_t len, const char* format,
+    const char* file, char* buf, uint32_t buf_len) {
+    if (buf_len == 0 || !IsBinaryLog(log, len)) {
+        return 0;
+    }
+    BinaryLogHead head = GetBinaryLogHead(log);
+    const char* data = log + sizeof(head);
+    const char* end = log + len;
+
+    // same as text log
+    uint32_t cur = 0;
+    int ret = snprintf(buf, buf_len, "[%s|", LevelName(head._level));
+    cur = ret > 0 && (uint32_t)ret < buf_len ? ret : buf_len - 1;
+    if (cur + __format_time_buf_size < buf_len) {
+        uint32_t size = __format_time_buf_size;
+        GetFormatTime(head._time / 1000, buf + cur, size);
+        cur += size;
+    }
+    ret = snprintf(buf + cur, buf_len - cur, "|%s:%u] ", file, head._line);
+    cur = ret > 0 && cur + ret < buf_len ? cur + ret : buf_len - 1;
+
+    char spec_str[64];
+    const char* p = format;
+    while (*p && cur + 1 < buf_len) {
+        const char* next = strchr(p, '%');
+        if (!next) {
+            next = p + strlen(p);
+        }
+        // chars before conversion
+        uint32_t size = (uint32_t)(next - p);
+        if (cur + size >= buf_len) {
+            size = buf_len - cur - 1;
+        }
+        memcpy(buf + cur, p, size);
+        cur += size;
+        p = next;
+        if (*p == 0 || cur + 1 >= buf_len) {
+            break;
+        }
+
+        if (p[1] == '%') {
+            buf[cur++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // arguments after the conversion which can't be formatted are not kept,
+        // print the rest as it is
+        FormatSpec spec;
+        if (!ParseSpec(p, spec) || (size_t)(spec._end - p) >= sizeof(spec_str)) {
+            size = (uint32_t)strlen(p);
+            if (cur + size >= buf_len) {
+                size = buf_len - cur - 1;
+            }
+            memcpy(buf + cur, p, size);
+            cur += size;
+            break;
+        }
+
+        ret = 0;
+        memcpy(spec_str, p, spec._end - p);
+        spec_str[spec._end - p] = 0;
+        if (!DecodeArg(spec, spec_str, data, end, buf + cur, buf_len - cur, ret)) {
+            break;
+        }
+        cur = ret > 0 && cur + ret < buf_len ? cur + ret : (ret > 0 ? buf_len - 1 : cur);
+        p = spec._end;
+    }
+    buf[cur] = 0;
+    return cur;
+}
+
+uint32_t FormatBinaryLog(const char* log, uint32_t len, char* buf, uint32_t buf_len) {
+    if (!IsBinaryLog(log, len)) {
+        return 0;
+    }
+    BinaryLogHead head = GetBinaryLogHead(log);
+    return FormatBinaryLog(log, len, (const char*)(uintptr_t)head._format,
+        (const char*)(uintptr_t)head._file, buf, buf_len);
+}
+
+}
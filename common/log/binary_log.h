@@ -0,0 +1,62 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_LOG_BINARY_LOG
+#define COMMON_LOG_BINARY_LOG
+
+#include <cstdint>
+#include <cstdarg>
+
+namespace cppnet {
+
+// a binary log keeps the address of format string and the raw arguments,
+// it's formatted to text later by the logger thread or by the log decoder.
+// format strings and file names must live as long as the process, literals
+// in LOG_* macros do. arguments are read as the format says:
+//   integer: 4 bytes, 8 bytes with l, ll, j, z, t
+//   float  : 8 bytes
+//   pointer: 8 bytes
+//   string : 2 bytes length and the chars
+// a text log starts with '[', a binary log starts with __binary_log_flag.
+static const uint16_t __binary_log_flag = 0xB10C;
+
+struct BinaryLogHead {
+    uint16_t _flag;
+    uint16_t _level;
+    uint32_t _line;
+    uint64_t _time;   // utc time in microseconds
+    uint64_t _format; // address of format string
+    uint64_t _file;   // address of file name
+};
+
+// records in binary log file, every one is type(1 byte), length(4 bytes) and data
+enum BinaryLogFileRecord {
+    BLFR_STRING = 1, // address(8 bytes) and chars of format string or file name
+    BLFR_BINARY = 2, // binary log
+    BLFR_TEXT   = 3, // text log
+};
+// buffer size enough for text of a binary log
+static const uint32_t __binary_log_text_size = 1024 * 4;
+// binary log file starts with it
+static const char __binary_log_file_magic[] = "CPPNETBLOG1\n";
+
+// write log head and arguments to buf, return the length.
+// strings are cut if the buf isn't enough.
+uint32_t EncodeBinaryLog(uint16_t level, const char* file, uint32_t line,
+    const char* format, va_list list, char* buf, uint32_t len);
+
+bool IsBinaryLog(const char* log, uint32_t len);
+BinaryLogHead GetBinaryLogHead(const char* log);
+
+// format binary log to text the same as text log, return the length.
+// format and file are the strings the addresses in head point to.
+uint32_t FormatBinaryLog(const char* log, uint32_t len, const char* format,
+    const char* file, char* buf, uint32_t buf_len);
+// format binary log written by current process
+uint32_t FormatBinaryLog(const char* log, uint32_t len, char* buf, uint32_t buf_len);
+
+}
+
+#endif
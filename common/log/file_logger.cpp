@@ -6,6 +6,7 @@
 #include <cstdio>
 #include <cstring>
 #include "common/util/time.h"
+#include "common/log/binary_log.h"
 #include "common/log/file_logger.h"
 
 namespace cppnet {
@@ -15,20 +16,19 @@ FileLogger::FileLogger(const std::string& file,
     uint16_t max_store_days,
     uint16_t time_offset):
     _file_name(file),
-    _time_offset(time_offset),
+    _period_start(0),
+    _period_end(0),
     _spilt_unit(unit) {
 
+    // logs carry their time, offset isn't needed
+    (void)time_offset;
     if (unit == FLSU_HOUR) {
-        _time_buf_len = 13; // xxxx-xx-xx:xx
         _max_file_num = max_store_days * 24;
 
     } else {
-        _time_buf_len = 10; // xxxx-xx-xx
         _max_file_num = max_store_days;
     }
 
-    memset(_time, 0, __file_logger_time_buf_size);
-
     Start();
 }
 
@@ -42,9 +42,17 @@ void FileLogger::Run() {
      while (!_stop) {
         auto log = Pop();
         if (log) {
-            CheckTime(log->_log);
+            // binary log is formatted in this thread
+            const char* text = log->_log;
+            uint32_t len = log->_len;
+            if (IsBinaryLog(log->_log, log->_len)) {
+                len = FormatBinaryLog(log->_log, log->_len, _format_buf, __binary_log_text_size);
+                text = _format_buf;
+            }
+
+            CheckTime(log->_time);
             if (_stream.is_open()) {
-                _stream.write(log->_log, log->_len);
+                _stream.write(text, len);
                 _stream.put('\n');
                 _stream.flush();
             }
@@ -87,19 +95,19 @@ void FileLogger::Fatal(std::shared_ptr<Log>& log) {
 
 void FileLogger::SetMaxStoreDays(uint16_t max) {
     if (_spilt_unit == FLSU_HOUR) {
-        _time_buf_len = 13; // xxxx-xx-xx:xx
         _max_file_num = max * 24;
 
     } else {
-        _time_buf_len = 10; // xxxx-xx-xx
         _max_file_num = max;
     }
 
     CheckExpireFiles();
 }
 
-void FileLogger::CheckTime(char* log) {
-    if (strncmp(_time, log + _time_offset, _time_buf_len) == 0) {
+void FileLogger::CheckTime(uint64_t time) {
+    // logs of threads are not in time order, the period only
+    // moves forward and late logs go to the current file
+    if (time < _period_end) {
         return;
     }
 
@@ -107,15 +115,23 @@ void FileLogger::CheckTime(char* log) {
         _stream.close();
     }
     
-    // get new time and file name
-    memcpy(_time, log + _time_offset, _time_buf_len);
+    // get new time period and file name
+    FormatTimeUnit unit = _spilt_unit == FLSU_HOUR ? FTU_HOUR : FTU_DAY;
+    GetTimePeriod(time, unit, _period_start, _period_end);
+
+    char time_buf[__file_logger_time_buf_size];
+    uint32_t size = __file_logger_time_buf_size;
+    GetFormatTime(time, time_buf, size, unit);
     std::string file_name(_file_name);
     file_name.append(".");
-    file_name.append(_time, _time_buf_len);
+    file_name.append(time_buf, size);
     file_name.append(".log");
 
-    _history_file_names.push(file_name);
-    CheckExpireFiles();
+    // don't delete a file which is still in use
+    if (_history_file_names.empty() || _history_file_names.back() != file_name) {
+        _history_file_names.push(file_name);
+        CheckExpireFiles();
+    }
 
     // open new log file
     _stream.open(file_name.c_str(), std::ios::app | std::ios::out);
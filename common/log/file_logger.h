@@ -10,6 +10,7 @@
 #include <queue>
 #include <fstream>
 
+#include "common/log/binary_log.h"
 #include "common/log/logger_interface.h"
 #include "common/thread/thread_with_queue.h"
 
@@ -25,6 +26,7 @@ class FileLogger:
     public ThreadWithQueue<std::shared_ptr<Log>> {
 
 public:
+    // time_offset isn't used, logs carry their time. it's kept for old callers.
     FileLogger(const std::string& file, 
         FileLoggerSpiltUnit unit = FLSU_DAY, 
         uint16_t max_store_days = 3,
@@ -48,7 +50,8 @@ public:
     uint16_t GetMAxStorDays() { return _max_file_num; }
 
 private:
-    void CheckTime(char* log);
+    // open the file of the time period which the log time is in
+    void CheckTime(uint64_t time);
     void CheckExpireFiles();
 
 private:
@@ -58,11 +61,12 @@ private:
     std::string   _file_name;
     std::fstream  _stream;
 
-    // for time check
-    uint16_t _time_offset;
-    uint8_t  _time_buf_len;
+    // time period of current file in utc milliseconds, checked for every log
+    uint64_t _period_start;
+    uint64_t _period_end;
     FileLoggerSpiltUnit _spilt_unit;
-    char     _time[__file_logger_time_buf_size];
+    // text of binary log
+    char     _format_buf[__binary_log_text_size];
 
     // for log file delete
     uint16_t _max_file_num;
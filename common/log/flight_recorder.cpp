@@ -0,0 +1,279 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#ifndef __win__
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+#include "common/util/time.h"
+#include "common/log/binary_log.h"
+#include "common/log/flight_recorder.h"
+
+namespace cppnet {
+
+struct RecorderSlot {
+    // 2 * index + 1 when it's being written, 2 * index + 2 when done
+    std::atomic<uint64_t> _seq;
+    uint32_t _len;
+    char     _log[__flight_recorder_slot_size - sizeof(uint64_t) - sizeof(uint32_t)];
+};
+
+struct RecorderRing {
+    std::unique_ptr<RecorderSlot[]> _slots;
+    uint32_t _mask;
+    // logs written, only changed by the owner thread
+    std::atomic<uint64_t> _write_index;
+    // owned by a thread, released when the thread exits
+    std::atomic_bool _in_use;
+
+    RecorderRing(uint32_t slot_num):
+        _slots(new RecorderSlot[slot_num]()),
+        _mask(slot_num - 1),
+        _write_index(0),
+        _in_use(true) {}
+};
+
+// record copied out of ring when dumping
+struct RecorderLog {
+    uint64_t    _time;
+    std::string _log;
+};
+
+static std::atomic<uint64_t> __recorder_id(0);
+
+// ring of current thread, released when the thread exits
+struct RecorderRingHolder {
+    uint64_t _recorder_id;
+    std::shared_ptr<RecorderRing> _ring;
+
+    RecorderRingHolder(): _recorder_id(0) {}
+    ~RecorderRingHolder() {
+        if (_ring) {
+            _ring->_in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+static thread_local RecorderRingHolder __recorder_ring_holder;
+
+#ifndef __win__
+// write end of the pipe of the recorder which dumps on signal
+static std::atomic<int32_t> __recorder_signal_pipe(-1);
+
+static void RecorderSignalHandler(int) {
+    // only async signal safe calls here
+    int32_t err = errno;
+    int32_t fd = __recorder_signal_pipe.load(std::memory_order_relaxed);
+    if (fd >= 0) {
+        char c = 'd';
+        if (write(fd, &c, 1) < 0) {
+            // the recorder thread is dumping already
+        }
+    }
+    errno = err;
+}
+#endif
+
+FlightRecorder::FlightRecorder(const std::string& file, uint32_t slot_num):
+    _id(++__recorder_id),
+    _slot_num(1),
+    _file_name(file) {
+
+    while (_slot_num < slot_num) {
+        _slot_num <<= 1;
+    }
+    _pipe[0] = -1;
+    _pipe[1] = -1;
+}
+
+FlightRecorder::~FlightRecorder() {
+    if (_thread) {
+        Stop();
+        Join();
+    }
+#ifndef __win__
+    int32_t fd = _pipe[1];
+    __recorder_signal_pipe.compare_exchange_strong(fd, -1);
+    if (_pipe[0] >= 0) {
+        close(_pipe[0]);
+        close(_pipe[1]);
+    }
+#endif
+}
+
+void FlightRecorder::Record(uint16_t level, const char* file, uint32_t line, const char* content, va_list list) {
+    RecorderRing* ring = GetRing();
+    uint64_t index = ring->_write_index.load(std::memory_order_relaxed);
+    RecorderSlot& slot = ring->_slots[index & ring->_mask];
+
+    slot._seq.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot._len = EncodeBinaryLog(level, file, line, content, list, slot._log, sizeof(slot._log));
+    slot._seq.store(index * 2 + 2, std::memory_order_release);
+
+    ring->_write_index.store(index + 1, std::memory_order_release);
+}
+
+std::string FlightRecorder::Dump() {
+    char time[__format_time_buf_size];
+    uint32_t size = __format_time_buf_size;
+    GetFormatTime(UTCTimeMsec(), time, size);
+
+    std::string file_name(_file_name);
+    file_name.append(".");
+    file_name.append(time, size);
+    file_name.append(".log");
+    if (!Dump(file_name)) {
+        return "";
+    }
+    return file_name;
+}
+
+bool FlightRecorder::Dump(const std::string& file) {
+    std::unique_lock<std::mutex> dump_lock(_dump_mutex);
+    std::vector<std::shared_ptr<RecorderRing>> rings;
+    {
+        std::unique_lock<std::mutex> lock(_ring_mutex);
+        rings = _rings;
+    }
+
+    // copy logs out, skip the slots being written or overwritten
+    std::vector<RecorderLog> logs;
+    for (auto ring = rings.begin(); ring != rings.end(); ring++) {
+        uint64_t end = (*ring)->_write_index.load(std::memory_order_acquire);
+        uint64_t start = end > _slot_num ? end - _slot_num : 0;
+        for (uint64_t i = start; i < end; i++) {
+            RecorderSlot& slot = (*ring)->_slots[i & (*ring)->_mask];
+            uint64_t seq = slot._seq.load(std::memory_order_acquire);
+            if (seq != i * 2 + 2) {
+                continue;
+            }
+            uint32_t len = slot._len;
+            if (len > sizeof(slot._log)) {
+                continue;
+            }
+            RecorderLog log;
+            log._log.assign(slot._log, len);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot._seq.load(std::memory_order_relaxed) != seq || !IsBinaryLog(log._log.data(), len)) {
+                continue;
+            }
+            log._time = GetBinaryLogHead(log._log.data())._time;
+            logs.push_back(std::move(log));
+        }
+    }
+    // logs of every thread are in order already
+    std::stable_sort(logs.begin(), logs.end(),
+        [](const RecorderLog& l, const RecorderLog& r) { return l._time < r._time; });
+
+    FILE* out = fopen(file.c_str(), "w");
+    if (!out) {
+        return false;
+    }
+    std::vector<char> buf(__binary_log_text_size);
+    uint32_t size = __format_time_buf_size;
+    int32_t len = snprintf(buf.data(), buf.size(), "[INF|");
+    GetFormatTime(buf.data() + len, size);
+    len += size;
+    len += snprintf(buf.data() + len, buf.size() - len, "|flight recorder] dump recorded logs. logs:%u, threads:%u\n",
+        (uint32_t)logs.size(), (uint32_t)rings.size());
+    fwrite(buf.data(), 1, len, out);
+
+    for (auto log = logs.begin(); log != logs.end(); log++) {
+        uint32_t log_len = FormatBinaryLog(log->_log.data(), (uint32_t)log->_log.size(), buf.data(), (uint32_t)buf.size());
+        fwrite(buf.data(), 1, log_len, out);
+        fputc('\n', out);
+    }
+    fclose(out);
+    return true;
+}
+
+bool FlightRecorder::DumpOnSignal(int sig) {
+#ifdef __win__
+    return false;
+#else
+    if (_pipe[0] < 0) {
+        if (pipe(_pipe) != 0) {
+            return false;
+        }
+        // the signal handler never blocks
+        fcntl(_pipe[1], F_SETFL, fcntl(_pipe[1], F_GETFL) | O_NONBLOCK);
+    }
+    __recorder_signal_pipe.store(_pipe[1]);
+
+    struct sigaction act;
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = RecorderSignalHandler;
+    act.sa_flags = SA_RESTART;
+    sigemptyset(&act.sa_mask);
+    if (sigaction(sig, &act, nullptr) != 0) {
+        return false;
+    }
+
+    Start();
+    return true;
+#endif
+}
+
+void FlightRecorder::Run() {
+#ifndef __win__
+    while (!_stop) {
+        char c;
+        ssize_t ret = read(_pipe[0], &c, 1);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0 || _stop) {
+            break;
+        }
+        Dump();
+    }
+#endif
+}
+
+void FlightRecorder::Stop() {
+    _stop = true;
+#ifndef __win__
+    char c = 's';
+    if (_pipe[1] >= 0 && write(_pipe[1], &c, 1) < 0) {
+        // pipe is full, the thread wakes up anyway
+    }
+#endif
+}
+
+RecorderRing* FlightRecorder::GetRing() {
+    if (__recorder_ring_holder._recorder_id == _id) {
+        return __recorder_ring_holder._ring.get();
+    }
+
+    // the thread records first time, reuse ring of an exited thread
+    if (__recorder_ring_holder._ring) {
+        __recorder_ring_holder._ring->_in_use.store(false, std::memory_order_release);
+    }
+    std::shared_ptr<RecorderRing> ring;
+    {
+        std::unique_lock<std::mutex> lock(_ring_mutex);
+        for (auto iter = _rings.begin(); iter != _rings.end(); iter++) {
+            bool in_use = false;
+            if ((*iter)->_in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+                ring = *iter;
+                break;
+            }
+        }
+        if (!ring) {
+            ring = std::make_shared<RecorderRing>(_slot_num);
+            _rings.push_back(ring);
+        }
+    }
+    __recorder_ring_holder._recorder_id = _id;
+    __recorder_ring_holder._ring = ring;
+    return ring.get();
+}
+
+} // namespace cppnet
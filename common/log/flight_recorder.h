@@ -0,0 +1,72 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_LOG_FLIGHT_RECORDER
+#define COMMON_LOG_FLIGHT_RECORDER
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdarg>
+
+#include "common/thread/thread.h"
+
+namespace cppnet {
+
+// size of one record, longer logs are cut
+static const uint32_t __flight_recorder_slot_size = 256;
+
+// every thread keeps its recent logs in a ring of fixed slots in memory,
+// the oldest one is overwritten. logs are kept as binary logs, see binary_log.h,
+// and formatted only when they are dumped. a slot is written without lock
+// and has a sequence like seqlock, the dump skips slots being written.
+// rings of exited threads are kept and reused by new threads.
+struct RecorderRing;
+class FlightRecorder:
+    public Thread {
+
+public:
+    // slot_num is rounded up to power of two
+    FlightRecorder(const std::string& file, uint32_t slot_num = 1024);
+    ~FlightRecorder();
+
+    // keep the log in the ring of current thread
+    void Record(uint16_t level, const char* file, uint32_t line, const char* content, va_list list);
+
+    // write logs of all threads in time order to a new file named by file and time,
+    // return the file name, empty if failed
+    std::string Dump();
+    bool Dump(const std::string& file);
+
+    // dump in a recorder thread when the signal comes, not on windows.
+    // only one recorder can dump on signal.
+    bool DumpOnSignal(int sig);
+
+    void Run();
+    void Stop();
+
+private:
+    RecorderRing* GetRing();
+
+private:
+    uint64_t    _id;
+    uint32_t    _slot_num;
+    std::string _file_name;
+
+    // rings of all threads, locked only when a thread records first time
+    std::mutex _ring_mutex;
+    std::vector<std::shared_ptr<RecorderRing>> _rings;
+
+    std::mutex _dump_mutex;
+    // signal handler wakes recorder thread up by the pipe
+    int32_t _pipe[2];
+};
+
+} // namespace cppnet
+
+#endif
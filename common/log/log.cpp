@@ -10,6 +10,8 @@
 
 namespace cppnet {
 
+std::atomic<uint16_t> __log_print_level(LL_INFO);
+
 SingletonLogger::SingletonLogger() {
     _logger = std::make_shared<BaseLogger>(__log_cache_size, __log_block_size);
 }
@@ -24,6 +26,25 @@ void SingletonLogger::SetLogger(std::shared_ptr<Logger> log) {
 
 void SingletonLogger::SetLevel(LogLevel level){
     _logger->SetLevel(level);
+    __log_print_level.store(_logger->GetLevel() | _logger->GetRecordLevel(), std::memory_order_relaxed);
+}
+
+void SingletonLogger::SetDeferFormat(bool defer) {
+    _logger->SetDeferFormat(defer);
+}
+
+void SingletonLogger::SetRecorder(std::shared_ptr<FlightRecorder> recorder) {
+    _logger->SetRecorder(recorder);
+    __log_print_level.store(_logger->GetLevel() | _logger->GetRecordLevel(), std::memory_order_relaxed);
+}
+
+void SingletonLogger::SetRecordLevel(LogLevel level) {
+    _logger->SetRecordLevel(level);
+    __log_print_level.store(_logger->GetLevel() | _logger->GetRecordLevel(), std::memory_order_relaxed);
+}
+
+std::string SingletonLogger::DumpRecord() {
+    return _logger->DumpRecord();
 }
 
 void SingletonLogger::Debug(const char* file, uint32_t line, const char* log...){
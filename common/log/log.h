@@ -6,10 +6,13 @@
 #ifndef QUIC_COMMON_LOG_LOG
 #define QUIC_COMMON_LOG_LOG
 
+#include <atomic>
 #include <memory>
+#include <string>
 #include <cstdint>
 
 #include "common/log/log_stream.h"
+#include "common/log/log_limiter.h"
 #include "common/util/singleton.h"
 
 namespace cppnet {
@@ -24,21 +27,86 @@ enum LogLevel {
     LL_DEBUG        = 0x10 | LL_INFO,
 };
 
+enum LogLevelMask {
+    LLM_FATAL        = 0x01,
+    LLM_ERROR        = 0x02,
+    LLM_WARN         = 0x04,
+    LLM_INFO         = 0x08,
+    LLM_DEBUG        = 0x10,
+};
+
+// logs more detailed than it are removed when compiling, set by -D__log_compile_level__=n.
+// 0: no log, 1: fatal, 2: error, 3: warn, 4: info, 5: debug
+#ifndef __log_compile_level__
+#define __log_compile_level__ 5
+#endif
+
+// levels set by LOG_SET_LEVEL and LOG_SET_RECORD_LEVEL, checked before log arguments are evaluated
+extern std::atomic<uint16_t> __log_print_level;
+
+// macros can be called as cppnet::LOG_XXX, so they start with a class name
+#define LOG_PRINT(compiled, mask, func, log, ...) \
+    SingletonLogger::IsOff<compiled>(mask) ? (void)0 : \
+    cppnet::SingletonLogger::Instance().func(__FILE__, __LINE__, log, ##__VA_ARGS__)
+#define LOG_PRINT_S(compiled, mask, level) \
+    SingletonLogger::IsOff<compiled>(mask) ? (void)0 : \
+    cppnet::LogVoidify() & cppnet::LogStream(cppnet::SingletonLogger::Instance().GetStreamParam(level, __FILE__, __LINE__))
+// every call site has its own limiter, logs suppressed in last window are counted in one line
+#define LOG_PRINT_LIMIT(compiled, mask, func, num, interval_ms, log, ...) \
+    SingletonLogger::IsOff<compiled>(mask) ? (void)0 : [&]() { \
+        static cppnet::LogLimiter __log_limiter; \
+        uint64_t __suppressed = 0; \
+        if (!__log_limiter.Allow(num, interval_ms, __suppressed)) { \
+            return; \
+        } \
+        if (__suppressed > 0) { \
+            cppnet::SingletonLogger::Instance().func(__FILE__, __LINE__, "%llu logs are suppressed here", \
+                (unsigned long long)__suppressed); \
+        } \
+        cppnet::SingletonLogger::Instance().func(__FILE__, __LINE__, log, ##__VA_ARGS__); \
+    }()
+#define LOG_PRINT_SAMPLE(compiled, mask, func, rate, log, ...) \
+    SingletonLogger::IsOff<compiled>(mask) || !cppnet::LogSample(rate) ? (void)0 : \
+    cppnet::SingletonLogger::Instance().func(__FILE__, __LINE__, log, ##__VA_ARGS__)
+
 // log interface for user
 #define LOG_SET(log)         SingletonLogger::Instance().SetLogger(log)
 #define LOG_SET_LEVEL(level) SingletonLogger::Instance().SetLevel(level)
-
-#define LOG_DEBUG(log, ...)  SingletonLogger::Instance().Debug(__FILE__, __LINE__, log, ##__VA_ARGS__)
-#define LOG_INFO(log, ...)   SingletonLogger::Instance().Info(__FILE__, __LINE__, log, ##__VA_ARGS__)
-#define LOG_WARN(log, ...)   SingletonLogger::Instance().Warn(__FILE__, __LINE__, log, ##__VA_ARGS__)
-#define LOG_ERROR(log, ...)  SingletonLogger::Instance().Error(__FILE__, __LINE__, log, ##__VA_ARGS__)
-#define LOG_FATAL(log, ...)  SingletonLogger::Instance().Fatal(__FILE__, __LINE__, log, ##__VA_ARGS__)
-
-#define LOG_DEBUG_S LogStream(cppnet::SingletonLogger::Instance().GetStreamParam(cppnet::LL_DEBUG, __FILE__, __LINE__))
-#define LOG_INFO_S  LogStream(cppnet::SingletonLogger::Instance().GetStreamParam(cppnet::LL_INFO, __FILE__, __LINE__))
-#define LOG_WARN_S  LogStream(cppnet::SingletonLogger::Instance().GetStreamParam(cppnet::LL_WARN, __FILE__, __LINE__))
-#define LOG_ERROR_S LogStream(cppnet::SingletonLogger::Instance().GetStreamParam(cppnet::LL_ERROR, __FILE__, __LINE__))
-#define LOG_FATAL_S LogStream(cppnet::SingletonLogger::Instance().GetStreamParam(cppnet::LL_FATAL, __FILE__, __LINE__))
+// logs are formatted by logger thread, not the thread which prints log
+#define LOG_SET_DEFER_FORMAT(defer) SingletonLogger::Instance().SetDeferFormat(defer)
+// keep recent logs of the record level in memory of every thread even if they are not printed,
+// they are dumped on fatal log or by LOG_DUMP_RECORD. see flight_recorder.h
+#define LOG_SET_RECORDER(recorder)  SingletonLogger::Instance().SetRecorder(recorder)
+#define LOG_SET_RECORD_LEVEL(level) SingletonLogger::Instance().SetRecordLevel(level)
+// return the dump file name, empty if failed
+#define LOG_DUMP_RECORD()           SingletonLogger::Instance().DumpRecord()
+
+// removed logs are still compiled but never run, the compiler drops them
+#define LOG_DEBUG(log, ...)  LOG_PRINT((__log_compile_level__ >= 5), cppnet::LLM_DEBUG, Debug, log, ##__VA_ARGS__)
+#define LOG_INFO(log, ...)   LOG_PRINT((__log_compile_level__ >= 4), cppnet::LLM_INFO, Info, log, ##__VA_ARGS__)
+#define LOG_WARN(log, ...)   LOG_PRINT((__log_compile_level__ >= 3), cppnet::LLM_WARN, Warn, log, ##__VA_ARGS__)
+#define LOG_ERROR(log, ...)  LOG_PRINT((__log_compile_level__ >= 2), cppnet::LLM_ERROR, Error, log, ##__VA_ARGS__)
+#define LOG_FATAL(log, ...)  LOG_PRINT((__log_compile_level__ >= 1), cppnet::LLM_FATAL, Fatal, log, ##__VA_ARGS__)
+
+#define LOG_DEBUG_S LOG_PRINT_S((__log_compile_level__ >= 5), cppnet::LLM_DEBUG, cppnet::LL_DEBUG)
+#define LOG_INFO_S  LOG_PRINT_S((__log_compile_level__ >= 4), cppnet::LLM_INFO, cppnet::LL_INFO)
+#define LOG_WARN_S  LOG_PRINT_S((__log_compile_level__ >= 3), cppnet::LLM_WARN, cppnet::LL_WARN)
+#define LOG_ERROR_S LOG_PRINT_S((__log_compile_level__ >= 2), cppnet::LLM_ERROR, cppnet::LL_ERROR)
+#define LOG_FATAL_S LOG_PRINT_S((__log_compile_level__ >= 1), cppnet::LLM_FATAL, cppnet::LL_FATAL)
+
+// for logs in hot paths, at most num logs in interval_ms at the call site
+#define LOG_DEBUG_LIMIT(num, interval_ms, log, ...) LOG_PRINT_LIMIT((__log_compile_level__ >= 5), cppnet::LLM_DEBUG, Debug, num, interval_ms, log, ##__VA_ARGS__)
+#define LOG_INFO_LIMIT(num, interval_ms, log, ...)  LOG_PRINT_LIMIT((__log_compile_level__ >= 4), cppnet::LLM_INFO, Info, num, interval_ms, log, ##__VA_ARGS__)
+#define LOG_WARN_LIMIT(num, interval_ms, log, ...)  LOG_PRINT_LIMIT((__log_compile_level__ >= 3), cppnet::LLM_WARN, Warn, num, interval_ms, log, ##__VA_ARGS__)
+#define LOG_ERROR_LIMIT(num, interval_ms, log, ...) LOG_PRINT_LIMIT((__log_compile_level__ >= 2), cppnet::LLM_ERROR, Error, num, interval_ms, log, ##__VA_ARGS__)
+#define LOG_FATAL_LIMIT(num, interval_ms, log, ...) LOG_PRINT_LIMIT((__log_compile_level__ >= 1), cppnet::LLM_FATAL, Fatal, num, interval_ms, log, ##__VA_ARGS__)
+
+// print one of about rate logs at random
+#define LOG_DEBUG_SAMPLE(rate, log, ...) LOG_PRINT_SAMPLE((__log_compile_level__ >= 5), cppnet::LLM_DEBUG, Debug, rate, log, ##__VA_ARGS__)
+#define LOG_INFO_SAMPLE(rate, log, ...)  LOG_PRINT_SAMPLE((__log_compile_level__ >= 4), cppnet::LLM_INFO, Info, rate, log, ##__VA_ARGS__)
+#define LOG_WARN_SAMPLE(rate, log, ...)  LOG_PRINT_SAMPLE((__log_compile_level__ >= 3), cppnet::LLM_WARN, Warn, rate, log, ##__VA_ARGS__)
+#define LOG_ERROR_SAMPLE(rate, log, ...) LOG_PRINT_SAMPLE((__log_compile_level__ >= 2), cppnet::LLM_ERROR, Error, rate, log, ##__VA_ARGS__)
+#define LOG_FATAL_SAMPLE(rate, log, ...) LOG_PRINT_SAMPLE((__log_compile_level__ >= 1), cppnet::LLM_FATAL, Fatal, rate, log, ##__VA_ARGS__)
 
 // log cache config
 static const uint16_t __log_cache_size = 20;
@@ -47,6 +115,7 @@ static const uint16_t __log_block_size = 1024;
 
 class Logger;
 class BaseLogger;
+class FlightRecorder;
 class SingletonLogger: 
     public Singleton<SingletonLogger> {
 
@@ -58,6 +127,18 @@ public:
 
     void SetLevel(LogLevel level);
 
+    void SetDeferFormat(bool defer);
+
+    void SetRecorder(std::shared_ptr<FlightRecorder> recorder);
+    void SetRecordLevel(LogLevel level);
+    std::string DumpRecord();
+
+    // compiled is false if the level is removed when compiling
+    template<bool compiled>
+    static bool IsOff(uint16_t mask) {
+        return !compiled || (__log_print_level.load(std::memory_order_relaxed) & mask) == 0;
+    }
+
     // for log print as printf
     void Debug(const char* file, uint32_t line, const char* log...);
     void Info(const char* file, uint32_t line, const char* log...);
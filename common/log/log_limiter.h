@@ -0,0 +1,60 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_LOG_LOG_LIMITER
+#define COMMON_LOG_LOG_LIMITER
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/util/time.h"
+
+namespace cppnet {
+
+// state of one rate limited log call site, shared by all threads.
+// it's on its own cache line, a log costs a coarse clock read and an add.
+class alignas(64) LogLimiter {
+public:
+    LogLimiter(): _window_start(0), _count(0) {}
+
+    // return true if the log can be printed, at most num logs in interval_ms.
+    // suppressed is set to logs dropped in last window when a new window begins.
+    bool Allow(uint32_t num, uint32_t interval_ms, uint64_t& suppressed) {
+        uint64_t now = CoarseSteadyTimeMsec();
+        uint64_t start = _window_start.load(std::memory_order_relaxed);
+        if (now - start >= interval_ms &&
+            _window_start.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            uint64_t count = _count.exchange(1, std::memory_order_relaxed);
+            suppressed = count > num ? count - num : 0;
+            return true;
+        }
+        return _count.fetch_add(1, std::memory_order_relaxed) < num;
+    }
+
+private:
+    std::atomic<uint64_t> _window_start;
+    // logs in current window, printed and suppressed
+    std::atomic<uint64_t> _count;
+};
+
+// return true once in rate times on average, random by thread
+inline bool LogSample(uint32_t rate) {
+    if (rate <= 1) {
+        return true;
+    }
+    static thread_local uint32_t __state = 0;
+    if (__state == 0) {
+        __state = (uint32_t)(uintptr_t)&__state | 1;
+    }
+    // xorshift
+    __state ^= __state << 13;
+    __state ^= __state >> 17;
+    __state ^= __state << 5;
+    return __state % rate == 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <cstring>
+#include "common/log/log_ring.h"
+
+namespace cppnet {
+
+// records start at multiple of it, so the head never crosses the end of ring
+static const uint32_t __record_align = 8;
+static const uint32_t __padding_flag = 0xFFFFFFFF;
+// length and time
+static const uint32_t __record_head_size = sizeof(uint32_t) + sizeof(uint64_t);
+
+static uint32_t RecordSize(uint32_t len) {
+    return (__record_head_size + len + __record_align - 1) & ~(__record_align - 1);
+}
+
+LogRing::LogRing(uint32_t size):
+    _size(__record_align),
+    _closed(false),
+    _write_pos(0),
+    _read_pos_cache(0),
+    _read_pos(0),
+    _front_next(0) {
+
+    while (_size < size) {
+        _size <<= 1;
+    }
+    _mask = _size - 1;
+    _buf = new char[_size];
+}
+
+LogRing::~LogRing() {
+    delete[] _buf;
+}
+
+bool LogRing::Push(const char* log, uint32_t len, uint64_t time) {
+    uint32_t need = RecordSize(len);
+    if (need > _size) {
+        return false;
+    }
+
+    uint64_t write_pos = _write_pos.load(std::memory_order_relaxed);
+    uint32_t offset = (uint32_t)(write_pos & _mask);
+    uint32_t tail_room = _size - offset;
+    // skip the end of ring if the record can't be continuous
+    uint32_t total = need > tail_room ? tail_room + need : need;
+
+    // only load read position when cached one shows the ring is full
+    if (write_pos + total - _read_pos_cache > _size) {
+        _read_pos_cache = _read_pos.load(std::memory_order_acquire);
+        if (write_pos + total - _read_pos_cache > _size) {
+            return false;
+        }
+    }
+
+    if (need > tail_room) {
+        memcpy(_buf + offset, &__padding_flag, sizeof(uint32_t));
+        write_pos += tail_room;
+        offset = 0;
+    }
+    memcpy(_buf + offset, &len, sizeof(uint32_t));
+    memcpy(_buf + offset + sizeof(uint32_t), &time, sizeof(uint64_t));
+    memcpy(_buf + offset + __record_head_size, log, len);
+
+    _write_pos.store(write_pos + need, std::memory_order_release);
+    return true;
+}
+
+const char* LogRing::Front(uint32_t& len, uint64_t& time) {
+    uint64_t read_pos = _read_pos.load(std::memory_order_relaxed);
+    if (read_pos == _write_pos.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    uint32_t offset = (uint32_t)(read_pos & _mask);
+    memcpy(&len, _buf + offset, sizeof(uint32_t));
+    // padding is always followed by a record at the start of ring
+    if (len == __padding_flag) {
+        read_pos += _size - offset;
+        offset = 0;
+        memcpy(&len, _buf, sizeof(uint32_t));
+    }
+
+    memcpy(&time, _buf + offset + sizeof(uint32_t), sizeof(uint64_t));
+
+    _front_next = read_pos + RecordSize(len);
+    return _buf + offset + __record_head_size;
+}
+
+void LogRing::Pop() {
+    _read_pos.store(_front_next, std::memory_order_release);
+}
+
+uint32_t LogRing::Size() {
+    // load read position first, it's never after write position
+    uint64_t read_pos = _read_pos.load(std::memory_order_acquire);
+    return (uint32_t)(_write_pos.load(std::memory_order_acquire) - read_pos);
+}
+
+}
@@ -0,0 +1,68 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_LOG_LOG_RING
+#define COMMON_LOG_LOG_RING
+
+#include <atomic>
+#include <cstdint>
+
+namespace cppnet {
+
+// single producer single consumer ring of log records, no lock.
+// every record is a head of length and time, and the log, and is continuous in the ring.
+// when the end of ring can't hold a record, it is skipped with a padding head.
+// Push is only called by the producer thread, Front and Pop by the consumer thread.
+class LogRing {
+public:
+    // size is rounded up to power of two
+    LogRing(uint32_t size);
+    ~LogRing();
+
+    // return false if there is no room
+    bool Push(const char* log, uint32_t len, uint64_t time);
+
+    // get the first record, return nullptr if empty
+    const char* Front(uint32_t& len, uint64_t& time);
+    // remove the record got by Front
+    void Pop();
+
+    // bytes in use
+    uint32_t Size();
+    uint32_t Capacity() { return _size; }
+
+    // producer thread exited, ring can be removed when it's empty
+    void Close() { _closed.store(true, std::memory_order_release); }
+    bool IsClosed() { return _closed.load(std::memory_order_acquire); }
+
+private:
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    enum : uint32_t {
+        __cache_line_size = 64,
+    };
+
+private:
+    char*    _buf;
+    uint32_t _size;
+    uint32_t _mask;
+    std::atomic_bool _closed;
+
+    // written by producer
+    char _pad1[__cache_line_size];
+    std::atomic<uint64_t> _write_pos;
+    uint64_t _read_pos_cache;
+
+    // written by consumer
+    char _pad2[__cache_line_size];
+    std::atomic<uint64_t> _read_pos;
+    uint64_t _front_next;
+    char _pad3[__cache_line_size];
+};
+
+}
+
+#endif
@@ -48,6 +48,12 @@ private:
     std::function<void(std::shared_ptr<Log>)> _call_back;
 };
 
+// makes the stream expression void in log macros
+class LogVoidify {
+public:
+    void operator&(const LogStream&) {}
+};
+
 } // namespace cppnet
 
 #endif
@@ -14,6 +14,7 @@ namespace cppnet {
 struct Log {
     char*    _log;
     uint32_t _len;
+    uint64_t _time; // utc time in milliseconds
 };
 
 // inherit this class to print log.
@@ -4,48 +4,47 @@
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
 #include <iostream>
+#include "common/log/binary_log.h"
 #include "common/log/stdout_logger.h"
 
 namespace cppnet {
 
 void StdoutLogger::Debug(std::shared_ptr<Log>& log) {
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-        std::cout<< log->_log << std::endl;
-    }
+    Print(log, std::cout);
     Logger::Debug(log);
 }
 
 void StdoutLogger::Info(std::shared_ptr<Log>& log) {
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-        std::cout<< log->_log << std::endl;
-    }
+    Print(log, std::cout);
     Logger::Info(log);
 }
 
 void StdoutLogger::Warn(std::shared_ptr<Log>& log) {
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-        std::cout<< log->_log << std::endl;
-    }
+    Print(log, std::cout);
     Logger::Warn(log);
 }
 
 void StdoutLogger::Error(std::shared_ptr<Log>& log) {
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-        std::cerr<< log->_log << std::endl;
-    }
+    Print(log, std::cerr);
     Logger::Error(log);
 }
 
 void StdoutLogger::Fatal(std::shared_ptr<Log>& log) {
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-        std::cerr<< log->_log << std::endl;
-    }
+    Print(log, std::cerr);
     Logger::Fatal(log);
 }
 
+void StdoutLogger::Print(std::shared_ptr<Log>& log, std::ostream& out) {
+    // binary log is formatted here
+    char buf[__binary_log_text_size];
+    const char* text = log->_log;
+    if (IsBinaryLog(log->_log, log->_len)) {
+        FormatBinaryLog(log->_log, log->_len, buf, __binary_log_text_size);
+        text = buf;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    out << text << std::endl;
+}
+
 } // namespace cppnet
@@ -7,10 +7,13 @@
 #define QUIC_COMMON_LOG_STDOUT_LOGGER
 
 #include <mutex>
+#include <ostream>
 #include "common/log/logger_interface.h"
 
 namespace cppnet {
 
+// prints with a lock and formats binary logs in the thread which logs.
+// AsyncFileLogger::SetPrintStdout keeps both off io threads.
 class StdoutLogger: 
     public Logger {
 
@@ -24,6 +27,9 @@ public:
     void Error(std::shared_ptr<Log>& log);
     void Fatal(std::shared_ptr<Log>& log);
 
+private:
+    void Print(std::shared_ptr<Log>& log, std::ostream& out);
+
 private:
     std::mutex _mutex;
 };
@@ -11,6 +11,7 @@
 namespace cppnet {
 
 void Localtime(const uint64_t* time, void* out_tm);
+void Gmtime(const uint64_t* time, void* out_tm);
 
 char* ErrnoInfo(uint32_t err);
 
@@ -13,6 +13,10 @@ void Localtime(const uint64_t* time, void* out_tm) {
     ::localtime_r((time_t*)time, (tm*)out_tm);
 }
 
+void Gmtime(const uint64_t* time, void* out_tm) {
+    ::gmtime_r((time_t*)time, (tm*)out_tm);
+}
+
 char* ErrnoInfo(uint32_t err) {
     return strerror(err);
 }
@@ -13,6 +13,10 @@ void Localtime(const uint64_t* time, void* out_tm) {
     localtime_s((tm*)out_tm, (time_t*)time);
 }
 
+void Gmtime(const uint64_t* time, void* out_tm) {
+    gmtime_s((tm*)out_tm, (time_t*)time);
+}
+
 char* ErrnoInfo(uint32_t err) {
     LPVOID  hlocal = NULL;
     ::FormatMessage(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER, NULL
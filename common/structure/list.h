@@ -92,6 +92,8 @@ public:
         if (!_head) {
             _tail.reset();
         }
+        // node may live longer than the list, e.g. shared buffer block
+        ret->SetNext(nullptr);
         
         _size--;
 
@@ -0,0 +1,149 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <vector>
+#include <cerrno>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/timerfd.h>
+#endif
+
+#include "common/log/log.h"
+#include "common/util/time.h"
+#include "common/timer/high_res_timer.h"
+
+namespace cppnet {
+
+HighResTimer::HighResTimer():
+    _timer_fd(-1),
+    _fd_deadline(0) {
+
+}
+
+HighResTimer::~HighResTimer() {
+#ifdef __linux__
+    if (_timer_fd >= 0) {
+        close(_timer_fd);
+        _timer_fd = -1;
+    }
+#endif
+}
+
+bool HighResTimer::Init() {
+#ifdef __linux__
+    _timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (_timer_fd < 0) {
+        LOG_ERROR("create timerfd failed. errno:%d", errno);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool HighResTimer::AddTimer(uint32_t timer_id, uint64_t interval_us, const high_res_timer_call_back& cb,
+    void* param, bool always) {
+    if (_timers.find(timer_id) != _timers.end()) {
+        return false;
+    }
+
+    // time out in next run at least
+    if (interval_us == 0) {
+        interval_us = 1;
+    }
+
+    TimerItem& item = _timers[timer_id];
+    item._interval = interval_us;
+    item._always = always;
+    item._param = param;
+    item._cb = cb;
+    item._deadline = _deadlines.emplace(SteadyTimeUsec() + interval_us, timer_id);
+
+    ResetTimerFd();
+    return true;
+}
+
+bool HighResTimer::RmTimer(uint32_t timer_id) {
+    auto iter = _timers.find(timer_id);
+    if (iter == _timers.end()) {
+        return false;
+    }
+    // timer is running if it has no deadline
+    if (iter->second._deadline != _deadlines.end()) {
+        _deadlines.erase(iter->second._deadline);
+    }
+    _timers.erase(iter);
+
+    ResetTimerFd();
+    return true;
+}
+
+void HighResTimer::OnTimeout() {
+#ifdef __linux__
+    uint64_t expirations = 0;
+    if (read(_timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        LOG_ERROR("read timerfd failed. errno:%d", errno);
+    }
+#endif
+    _fd_deadline = 0;
+
+    // take out arrived timers first, call back may add or remove timers
+    uint64_t now = SteadyTimeUsec();
+    std::vector<std::pair<uint64_t, uint32_t>> run_timers;
+    while (!_deadlines.empty() && _deadlines.begin()->first <= now) {
+        run_timers.push_back(*_deadlines.begin());
+        _timers[_deadlines.begin()->second]._deadline = _deadlines.end();
+        _deadlines.erase(_deadlines.begin());
+    }
+
+    for (auto run = run_timers.begin(); run != run_timers.end(); run++) {
+        auto iter = _timers.find(run->second);
+        // removed or added again by call back
+        if (iter == _timers.end() || iter->second._deadline != _deadlines.end()) {
+            continue;
+        }
+
+        TimerItem& item = iter->second;
+        high_res_timer_call_back cb = item._cb;
+        void* param = item._param;
+        if (item._always) {
+            // keep the period from last deadline, skip the periods already missed
+            uint64_t deadline = run->first + ((now - run->first) / item._interval + 1) * item._interval;
+            item._deadline = _deadlines.emplace(deadline, run->second);
+
+        } else {
+            _timers.erase(iter);
+        }
+        cb(param);
+    }
+
+    ResetTimerFd();
+}
+
+void HighResTimer::ResetTimerFd() {
+#ifdef __linux__
+    uint64_t deadline = _deadlines.empty() ? 0 : _deadlines.begin()->first;
+    if (deadline == _fd_deadline) {
+        return;
+    }
+
+    // zero value stops the timer
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = (time_t)(deadline / 1000000);
+    spec.it_value.tv_nsec = (long)(deadline % 1000000) * 1000;
+    if (timerfd_settime(_timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+        LOG_ERROR("set timerfd failed. errno:%d", errno);
+        return;
+    }
+    _fd_deadline = deadline;
+#endif
+}
+
+std::shared_ptr<HighResTimer> MakeHighResTimer() {
+    return std::make_shared<HighResTimer>();
+}
+
+}
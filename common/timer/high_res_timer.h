@@ -0,0 +1,67 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_TIMER_HIGH_RES_TIMER
+#define COMMON_TIMER_HIGH_RES_TIMER
+
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace cppnet {
+
+using high_res_timer_call_back = std::function<void (void*)>;
+
+// timers in microseconds. deadlines are kept in order and the earliest one
+// is set to a timerfd of CLOCK_MONOTONIC, the fd is readable when it arrives.
+// only linux supports it, Init returns false on other platforms.
+// all functions must be called in one thread.
+class HighResTimer {
+public:
+    HighResTimer();
+    ~HighResTimer();
+
+    bool Init();
+    // add to event actions for read
+    int32_t GetFd() { return _timer_fd; }
+
+    // time out after interval microseconds
+    bool AddTimer(uint32_t timer_id, uint64_t interval_us, const high_res_timer_call_back& cb,
+        void* param, bool always = false);
+    bool RmTimer(uint32_t timer_id);
+
+    // call when fd is readable, run all arrived timers
+    void OnTimeout();
+
+    bool Empty() { return _timers.empty(); }
+
+private:
+    // set the earliest deadline to timerfd
+    void ResetTimerFd();
+
+    struct TimerItem {
+        uint64_t _interval;
+        bool     _always;
+        void*    _param;
+        high_res_timer_call_back _cb;
+        std::multimap<uint64_t, uint32_t>::iterator _deadline;
+    };
+
+private:
+    int32_t  _timer_fd;
+    // deadline set to timerfd, 0 means not set
+    uint64_t _fd_deadline;
+    // deadline in microseconds to timer id
+    std::multimap<uint64_t, uint32_t> _deadlines;
+    std::unordered_map<uint32_t, TimerItem> _timers;
+};
+
+std::shared_ptr<HighResTimer> MakeHighResTimer();
+
+}
+
+#endif
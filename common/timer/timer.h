@@ -17,6 +17,10 @@ std::shared_ptr<Timer> MakeTimer1Min();
 
 std::shared_ptr<Timer> MakeTimer1Hour();
 
+// interval of timer has no limit, timers longer
+// than days level go round the wheel
+std::shared_ptr<Timer> MakeTimerUnlimited();
+
 }
 
 #endif
\ No newline at end of file
@@ -3,28 +3,54 @@
 
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
-#include <algorithm>
 #include "common/timer/timer_slot.h"
 #include "common/timer/timer_container.h"
 
 namespace cppnet {
 
-TimerContainer::TimerContainer(std::shared_ptr<TimerContainer> sub_timer, TIME_UNIT unit, TIME_UNIT max):
-    _time_unit(unit),
-    _size(max / unit),
-    _timer_max(max),
-    _cur_time(0),
-    _sub_timer(sub_timer) {
+// bucket time and bucket num of every level.
+// the whole wheel is 24 days, current time still fits int32_t.
+static const uint32_t __level_units[][2] = {
+    {TU_MILLISECOND, 1000},
+    {TU_SECOND,      60},
+    {TU_MINUTE,      60},
+    {TU_HOUR,        24},
+    {TU_DAY,         24},
+};
+static const uint32_t __level_num = sizeof(__level_units) / sizeof(__level_units[0]);
+
+// largest power of two not more than slack
+static uint64_t SlackAlign(uint32_t slack) {
+    uint64_t align = 1;
+    while (align * 2 <= slack) {
+        align *= 2;
+    }
+    return align;
+}
 
-    _bitmap.Init(_size);
+TimerContainer::TimerContainer(uint32_t max):
+    _timer_max(max),
+    _wheel_time(0),
+    _now(0) {
+
+    _levels.reserve(__level_num);
+    for (uint32_t i = 0; i < __level_num && (max == 0 || __level_units[i][0] < max); i++) {
+        _levels.emplace_back();
+        Level& level = _levels.back();
+        level._unit = __level_units[i][0];
+        level._size = __level_units[i][1];
+        level._bitmap.Init(level._size);
+        level._buckets.reset(new TimerNode[level._size]);
+        _wheel_time = (uint64_t)level._unit * level._size;
+    }
 }
 
 TimerContainer::~TimerContainer() {
-
+    Clear();
 }
 
-bool TimerContainer::AddTimer(std::weak_ptr<TimerSlot> t, uint32_t time, bool always) {
-    if (time >= _timer_max) {
+bool TimerContainer::AddTimer(std::weak_ptr<TimerSlot> t, uint32_t time, bool always, uint32_t slack) {
+    if (_timer_max > 0 && time >= _timer_max) {
         return false;
     }
 
@@ -33,23 +59,30 @@ bool TimerContainer::AddTimer(std::weak_ptr<TimerSlot> t, uint32_t time, bool al
         return false;
     }
 
-    if (time < _time_unit && _sub_timer) {
-        return _sub_timer->AddTimer(t, time, always);
+    if (ptr->IsInTimer()) {
+        return false;
+    }
+    ptr->SetInterval(time);
+    ptr->SetSlack(slack);
+    ptr->SetInTimer();
+    if (always) {
+        ptr->SetAlways();
     }
 
-    // set current timer unit interval
-    if (!ptr->IsInTimer()) {
-        ptr->SetInterval(time);
-        ptr->SetInTimer();
-        if (always) {
-            ptr->SetAlways();
+    // time out in next run at least
+    ptr->_expire = _now + (time > 0 ? time : 1);
+    // move to the next multiple of the largest power of two within slack,
+    // timers with overlapped windows time out at the same time
+    if (slack > 1) {
+        uint64_t align = SlackAlign(slack);
+        uint64_t expire = (ptr->_expire + align - 1) / align * align;
+        if (expire - _now < _wheel_time) {
+            ptr->_expire = expire;
         }
-
-    } else {
-        return false;
     }
-
-    return InnerAddTimer(ptr, time);
+    ptr->_self = t;
+    InnerAddTimer(ptr.get());
+    return true;
 }
 
 bool TimerContainer::RmTimer(std::weak_ptr<TimerSlot> t) {
@@ -58,275 +91,185 @@ bool TimerContainer::RmTimer(std::weak_ptr<TimerSlot> t) {
         return false;
     }
 
-    uint16_t cur_index = 0;
-    uint16_t type = 0;
-    ptr->GetCurIndex(cur_index, type);
-    if (type == TimeUnit2TimeType(_time_unit)) {
-        ptr->RmInTimer();
-        _bitmap.Remove(cur_index);
-        uint32_t left_time = ptr->GetLeftInterval();
-        auto timer_map = _timer_wheel.find(cur_index);
-        if (timer_map == _timer_wheel.end()) {
-            return true;
-        }
-        // don't have sub timer
-        if (!_sub_timer) {
-            left_time = 0;
-        }
-        auto timer_list = timer_map->second.find(left_time);
-        if (timer_list == timer_map->second.end()) {
-            return false;
-        }
-        for (auto timer = timer_list->second.begin(); timer != timer_list->second.end(); ++timer) {
-            auto target = timer->lock();
-            if (target == ptr) {
-                timer_list->second.erase(timer);
-                return true;
-            }
-        }
-        return true;
+    ptr->RmInTimer();
+    ptr->RmAlways();
+    if (!ptr->IsLinked()) {
+        return false;
     }
 
-    if (_sub_timer) {
-        return _sub_timer->RmTimer(t);
+    ptr->Unlink();
+    Level& level = _levels[ptr->_level];
+    if (!level._buckets[ptr->_index].IsLinked()) {
+        level._bitmap.Remove(ptr->_index);
     }
-    return false;
+    return true;
 }
 
 int32_t TimerContainer::MinTime() {
-    uint32_t past_time = 0;
-    int32_t sub_time = 0;
-    int32_t local_time = LocalMinTime();
-
-    if (_sub_timer) {
-        sub_time = _sub_timer->MinTime();
-        past_time += _sub_timer->CurrentTimer();
-
-        if (sub_time > 0) {
-            local_time = local_time - past_time;
-            if (local_time > 0) {
-                return std::min(local_time, sub_time);
-            }
-            return sub_time;
-
-        } else if (local_time > 0){
-            return local_time - past_time;
+    int64_t min_time = NO_TIMER;
+    for (uint16_t i = 0; i < _levels.size(); i++) {
+        int64_t level_time = LevelMinTime(i);
+        if (level_time >= 0 && (min_time < 0 || level_time < min_time)) {
+            min_time = level_time;
         }
     }
-
-    return local_time;
+    return (int32_t)min_time;
 }
 
 int32_t TimerContainer::CurrentTimer() {
-    uint32_t ret = _cur_time * _time_unit;
-    if (_sub_timer) {
-        ret += _sub_timer->CurrentTimer();
-    }
-    return ret;
+    return (int32_t)(_now % _wheel_time);
 }
 
 uint32_t TimerContainer::TimerRun(uint32_t time) {
-    uint32_t time_pass = time / _time_unit;
-    uint32_t left_time = time % _time_unit;
-    bool do_timer = time_pass > 0;
-
-    if (left_time > 0) {
-        uint32_t sub_run_step = _sub_timer->TimerRun(left_time);
-        if (sub_run_step > 0) {
-            do_timer = true;
-        }
-        _cur_time += sub_run_step;
-    }
-
-    if (!do_timer) {
-        uint32_t run_setp = 0;
-        if (_cur_time >= _size) {
-            _cur_time -= _size;
-            run_setp++;
-        }
-        return run_setp;
-    }
-
-    std::vector<std::weak_ptr<TimerSlot>> run_timer_solts;
-    std::vector<std::weak_ptr<TimerSlot>> sub_timer_solts;
-
-    uint32_t prev_time = _cur_time;
-    _cur_time += time_pass;
-    while(1) {
-        int32_t next_time = _bitmap.GetMinAfter(prev_time);
-        if (next_time < 0) {
+    uint64_t target = _now + time;
+    uint32_t carry = (uint32_t)(target / _wheel_time - _now / _wheel_time);
+
+    TimerNode run_list;
+    while (_now < target) {
+        // jump to the next time which has bucket to handle
+        int64_t step = MinTime();
+        if (step < 0 || _now + step > target) {
+            _now = target;
             break;
         }
-        if (next_time > (int32_t)_cur_time) {
-            break;
-        }
-        GetIndexTimer(run_timer_solts, sub_timer_solts, next_time, left_time);
-        prev_time = next_time + 1;
-    }
+        _now += step;
 
-    uint32_t run_setp = 0;
-    if (_cur_time >= _size) {
-        _cur_time -= _size;
-        run_setp++;
-    }
-
-    if (run_setp > 0) {
-        prev_time = 0;
-        while (1) {
-            int32_t next_time = _bitmap.GetMinAfter(prev_time);
-            if (next_time < 0) {
-                break;
-            }
-            if (next_time > (int32_t)_cur_time) {
-                break;
+        // upper levels first, timers moved down may time out now
+        for (int32_t i = (int32_t)_levels.size() - 1; i >= 0; i--) {
+            Level& level = _levels[i];
+            if (_now % level._unit != 0) {
+                continue;
             }
-            GetIndexTimer(run_timer_solts, sub_timer_solts, next_time, left_time);
-            prev_time = next_time + 1;
+            HandleBucket((uint16_t)i, (uint32_t)((_now / level._unit) % level._size), run_list);
         }
     }
 
-    // timer call back
-    DoTimer(run_timer_solts, sub_timer_solts);
-
-    return run_setp;
+    // call back after the wheel moved, timers added in call back get right position
+    DoTimer(run_list);
+    return carry;
 }
 
 bool TimerContainer::Empty() {
-    return _bitmap.Empty();
+    return MinTime() < 0;
 }
 
 void TimerContainer::Clear() {
-    _bitmap.Clear();
-    _timer_wheel.clear();
-    if (_sub_timer) {
-        _sub_timer->Clear();
+    for (auto level = _levels.begin(); level != _levels.end(); level++) {
+        int32_t index = level->_bitmap.GetMinAfter(0);
+        while (index >= 0) {
+            TimerNode& bucket = level->_buckets[index];
+            while (bucket.IsLinked()) {
+                TimerSlot* slot = static_cast<TimerSlot*>(bucket._next);
+                slot->Unlink();
+                slot->RmInTimer();
+            }
+            index = level->_bitmap.GetMinAfter(index + 1);
+        }
+        level->_bitmap.Clear();
     }
 }
 
-int32_t TimerContainer::LocalMinTime() {
-    int32_t next_time = _bitmap.GetMinAfter(_cur_time);
-    if (next_time >= 0) {
-        return (next_time - _cur_time) * _time_unit + GetIndexLeftInterval(next_time);
+void TimerContainer::InnerAddTimer(TimerSlot* slot) {
+    uint64_t left_time = slot->_expire > _now ? slot->_expire - _now : 0;
+
+    // the lowest level which can hold the left time, or the top level
+    uint16_t index = 0;
+    while (index + 1 < (uint16_t)_levels.size() && left_time >= _levels[index + 1]._unit) {
+        index++;
     }
 
-    if (_cur_time > 0) {
-        next_time = _bitmap.GetMinAfter(0);
-        
-        if (next_time >= 0) {
-            return (next_time + _size - _cur_time) * _time_unit + GetIndexLeftInterval(next_time);
+    Level& level = _levels[index];
+    uint32_t bucket = (uint32_t)((slot->_expire / level._unit) % level._size);
+    slot->_level = (uint8_t)index;
+    slot->_index = (uint16_t)bucket;
+    slot->LinkBefore(&level._buckets[bucket]);
+    level._bitmap.Insert(bucket);
+}
+
+int64_t TimerContainer::LevelMinTime(uint16_t index) {
+    Level& level = _levels[index];
+    uint64_t cur_pos = _now / level._unit;
+    uint32_t cur_index = (uint32_t)(cur_pos % level._size);
+
+    while (!level._bitmap.Empty()) {
+        // current bucket was handled when the wheel arrived
+        int32_t next = level._bitmap.GetMinAfter(cur_index + 1);
+        if (next < 0) {
+            next = level._bitmap.GetMinAfter(0);
+        }
+        if (next < 0) {
+            break;
         }
+        // timers were destroyed
+        if (!level._buckets[next].IsLinked()) {
+            level._bitmap.Remove(next);
+            continue;
+        }
+        uint32_t step = (next + level._size - cur_index - 1) % level._size + 1;
+        return (int64_t)((cur_pos + step) * level._unit - _now);
     }
     return NO_TIMER;
 }
 
-bool TimerContainer::InnerAddTimer(std::shared_ptr<TimerSlot> ptr, uint32_t time) {
-    if (time > _timer_max) {
-        return false;
-    }
-    
-    uint16_t cur_index = time / _time_unit + _cur_time;
-    if (cur_index >= _size) {
-        cur_index -= _size;
-    }
-    uint32_t left_time = time % _time_unit;
-    // don't have sub timer
-    if (!_sub_timer) {
-        left_time = 0;
-    }
-    ptr->SetCurIndex(cur_index, TimeUnit2TimeType(_time_unit));
-    ptr->TimePass(time - left_time);
+void TimerContainer::HandleBucket(uint16_t index, uint32_t bucket_index, TimerNode& run_list) {
+    Level& level = _levels[index];
+    level._bitmap.Remove(bucket_index);
 
-    _timer_wheel[cur_index][left_time].push_back(ptr);
-    return _bitmap.Insert(cur_index);
-}
+    TimerNode& bucket = level._buckets[bucket_index];
+    if (!bucket.IsLinked()) {
+        return;
+    }
 
-uint16_t TimerContainer::TimeUnit2TimeType(TIME_UNIT tu) {
-    switch (tu)
-    {
-    case TU_MILLISECOND:
-        return TIT_MILLISECOND;
-    case TU_SECOND:
-        return TIT_SECOND;
-    case TU_MINUTE:
-        return TIT_MINUTE;
-    default:
-        throw "invalid time unit";
+    // time out, move the whole list
+    if (index == 0) {
+        MoveList(bucket, run_list);
+        return;
     }
-}
 
-uint32_t TimerContainer::GetIndexLeftInterval(uint16_t index) {
-    uint32_t left_interval = 0;
-    auto timer_map = _timer_wheel.find(index);
-    if (timer_map != _timer_wheel.end() && !timer_map->second.empty()) {
-        left_interval = timer_map->second.begin()->first;
+    // left time is less than unit of the level now, move to lower level.
+    // timers longer than the wheel come back to this bucket of top level.
+    TimerNode move_list;
+    MoveList(bucket, move_list);
+    while (move_list.IsLinked()) {
+        TimerSlot* slot = static_cast<TimerSlot*>(move_list._next);
+        slot->Unlink();
+        InnerAddTimer(slot);
     }
-    return left_interval;
 }
 
-void TimerContainer::GetIndexTimer(std::vector<std::weak_ptr<TimerSlot>>& run_timer_solts, 
-    std::vector<std::weak_ptr<TimerSlot>>& sub_timer_solts, uint32_t index, uint32_t time_pass) {
-    auto bucket_iter = _timer_wheel.find(index);
-    if (bucket_iter == _timer_wheel.end()) {
+void TimerContainer::MoveList(TimerNode& from, TimerNode& to) {
+    if (!from.IsLinked()) {
         return;
     }
-    auto& bucket = bucket_iter->second;
-
-    for (auto timer_list = bucket.begin(); timer_list != bucket.end(); timer_list++) {
-        if (timer_list->first == 0) {
-            run_timer_solts.insert(run_timer_solts.end(), timer_list->second.begin(), timer_list->second.end());
-            continue;
-        }
-
-        if (timer_list->first <= time_pass) {
-            run_timer_solts.insert(run_timer_solts.end(), timer_list->second.begin(), timer_list->second.end());
-            continue;
-        }
-
-        for (auto timer = timer_list->second.begin(); timer != timer_list->second.end(); timer++) {
-            auto target = timer->lock();
-            sub_timer_solts.push_back(target);
-        }
-    }
-
-    _bitmap.Remove(_cur_time);
-    _timer_wheel.erase(bucket_iter);
+    TimerNode* first = from._next;
+    TimerNode* last = from._prev;
+    first->_prev = to._prev;
+    to._prev->_next = first;
+    last->_next = &to;
+    to._prev = last;
+    from._prev = &from;
+    from._next = &from;
 }
 
-void TimerContainer::DoTimer(std::vector<std::weak_ptr<TimerSlot>>& run_timer_solts,
-    std::vector<std::weak_ptr<TimerSlot>>& sub_timer_solts) {
-    // timer call back
-    for (auto iter = run_timer_solts.begin(); iter != run_timer_solts.end(); iter++) {
-        auto ptr = iter->lock();
+void TimerContainer::DoTimer(TimerNode& run_list) {
+    while (run_list.IsLinked()) {
+        TimerSlot* slot = static_cast<TimerSlot*>(run_list._next);
+        slot->Unlink();
+
+        auto ptr = slot->_self.lock();
         if (!ptr) {
+            slot->RmInTimer();
             continue;
         }
-        ptr->OnTimer();
+        // clear flag first, so the slot can add itself again in call back
         ptr->RmInTimer();
+        ptr->OnTimer();
 
         // add timer again
-        if (ptr->IsAlways()) {
-            ptr->ResetTime();
-            auto root_timer = _root_timer.lock();
-            if (root_timer) {
-                root_timer->AddTimer(ptr, ptr->GetTotalInterval(), ptr->IsAlways());
-            }
-            else {
-                AddTimer(ptr, ptr->GetTotalInterval(), ptr->IsAlways());
-            }
+        if (ptr->IsAlways() && !ptr->IsInTimer()) {
+            AddTimer(ptr, ptr->GetTotalInterval(), true, ptr->GetSlack());
         }
     }
-
-    // add sub timer
-    if (!_sub_timer) {
-        return;
-    }
-    for (auto iter = sub_timer_solts.begin(); iter != sub_timer_solts.end(); iter++) {
-        auto ptr = iter->lock();
-        if (!ptr) {
-            continue;
-        }
-        _sub_timer->InnerAddTimer(ptr, ptr->GetLeftInterval());
-    }
 }
 
-}
\ No newline at end of file
+}
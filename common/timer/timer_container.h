@@ -6,29 +6,31 @@
 #ifndef COMMON_TIMER_TIMER_CONTAINER
 #define COMMON_TIMER_TIMER_CONTAINER
 
-#include <map>
-#include <list>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 #include "common/util/bitmap.h"
+#include "common/timer/timer_slot.h"
 #include "common/timer/timer_interface.h"
 
 namespace cppnet {
 
-// timer wheel container, include a sub timer.
-// if set timeout time is little than accuracy, will be added to sub timer wheel.
-// It inherits from the timer interface, 
-// so can set another timer wheel container to sub timer to support more timer set.
+// hierarchical timer wheel. the lowest level has a bucket for every millisecond
+// of one second, upper levels have a bucket for every second, minute, hour and day.
+// timers are linked into buckets by the list node in timer slot, so add, remove
+// and time out are O(1) and don't allocate memory. timers of upper level bucket
+// are moved down when the wheel arrives at the bucket. timers longer than the
+// whole wheel stay in the top level and go round until the left time is short.
 // More timer define see timer.h file.
-class TimerContainer: 
+class TimerContainer:
     public Timer {
 
 public:
-    TimerContainer(std::shared_ptr<TimerContainer> sub_timer, TIME_UNIT unit, TIME_UNIT max);
+    // max: timer interval must be less than it, 0 means no limit
+    TimerContainer(uint32_t max);
     ~TimerContainer();
 
-    bool AddTimer(std::weak_ptr<TimerSlot> t, uint32_t time, bool always = false);
+    bool AddTimer(std::weak_ptr<TimerSlot> t, uint32_t time, bool always = false, uint32_t slack = 0);
     bool RmTimer(std::weak_ptr<TimerSlot> t);
 
     // get min next time out time
@@ -38,40 +40,40 @@ public:
     int32_t MinTime();
     // return the timer wheel current time
     int32_t CurrentTimer();
-    // timer wheel run time 
+    // timer wheel run time
     // return carry
-    uint32_t TimerRun(uint32_t step);
+    uint32_t TimerRun(uint32_t time);
 
     bool Empty();
     void Clear();
 
-    // get current timer wheel timeout time
-    int32_t LocalMinTime();
-    bool InnerAddTimer(std::shared_ptr<TimerSlot> ptr, uint32_t time);
-
-    void SetRootTimer(std::shared_ptr<TimerContainer> timer) { _root_timer = timer; }
-
-protected:
-    uint16_t TimeUnit2TimeType(TIME_UNIT tu);
-    uint32_t GetIndexLeftInterval(uint16_t index);
-    void GetIndexTimer(std::vector<std::weak_ptr<TimerSlot>>& run_timer_solts, 
-        std::vector<std::weak_ptr<TimerSlot>>& sub_timer_solts, uint32_t index, uint32_t time_pass);
-    void DoTimer(std::vector<std::weak_ptr<TimerSlot>>& run_timer_solts,
-        std::vector<std::weak_ptr<TimerSlot>>& sub_timer_solts);
-
-protected:
-    TIME_UNIT _time_unit;
-    uint32_t  _size;
-    uint32_t  _timer_max;
-
-    uint32_t _cur_time;
-    Bitmap   _bitmap;
-    std::weak_ptr<TimerContainer>   _root_timer;
-    std::shared_ptr<TimerContainer> _sub_timer;
-    std::unordered_map<uint32_t, std::map<uint32_t, std::list<std::weak_ptr<TimerSlot>>>> _timer_wheel;
-    //std::unordered_map<uint32_t, std::list<std::weak_ptr<TimerSlot>>> _timer_wheel;
+private:
+    struct Level {
+        uint32_t _unit;   // time of one bucket
+        uint32_t _size;   // bucket num
+        Bitmap   _bitmap; // not empty buckets
+        std::unique_ptr<TimerNode[]> _buckets;
+    };
+
+    // link timer to bucket by expire time
+    void InnerAddTimer(TimerSlot* slot);
+    // time from now to next bucket need to handle of the level
+    int64_t LevelMinTime(uint16_t level);
+    // move timers of bucket down, or to run list at the lowest level
+    void HandleBucket(uint16_t level, uint32_t index, TimerNode& run_list);
+    // append all timers of from list to the end of to list
+    void MoveList(TimerNode& from, TimerNode& to);
+    void DoTimer(TimerNode& run_list);
+
+private:
+    uint32_t _timer_max;
+    // time covered by all levels
+    uint64_t _wheel_time;
+    // passed time since the wheel created
+    uint64_t _now;
+    std::vector<Level> _levels;
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
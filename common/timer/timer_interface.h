@@ -17,6 +17,7 @@ enum TIME_UNIT: uint32_t {
     TU_SECOND      = TU_MILLISECOND * 1000,
     TU_MINUTE      = TU_SECOND * 60,
     TU_HOUR        = TU_MINUTE * 60,
+    TU_DAY         = TU_HOUR * 24,
 };
 
 enum TIMER_CODE {
@@ -31,7 +32,9 @@ public:
     Timer() {}
     ~Timer() {}
 
-    virtual bool AddTimer(std::weak_ptr<TimerSlot> t, uint32_t time, bool always = false) = 0;
+    // slack: the timer may time out up to slack later, timers
+    // arrive in the same window are run by one wake up.
+    virtual bool AddTimer(std::weak_ptr<TimerSlot> t, uint32_t time, bool always = false, uint32_t slack = 0) = 0;
     virtual bool RmTimer(std::weak_ptr<TimerSlot> t) = 0;
 
     // get min next time out time
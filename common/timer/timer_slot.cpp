@@ -7,67 +7,61 @@
 
 namespace cppnet {
 
-TimerSlot::TimerSlot():
-    _total_interval(0),
-    _left_interval(0) {
-
+void TimerNode::Unlink() {
+    _prev->_next = _next;
+    _next->_prev = _prev;
+    _prev = this;
+    _next = this;
 }
 
-void TimerSlot::SetInterval(uint32_t interval) {
-    _total_interval = interval;
-    _left_interval = interval;
+void TimerNode::LinkBefore(TimerNode* node) {
+    _prev = node->_prev;
+    _next = node;
+    node->_prev->_next = this;
+    node->_prev = this;
 }
 
-uint32_t TimerSlot::GetTotalInterval() { 
-    _total_interval &= ~(TSF_ALWAYS | TSF_IN_TIMER);
-    return _total_interval; 
-}
+TimerSlot::TimerSlot():
+    _total_interval(0),
+    _slack(0),
+    _index(0),
+    _level(0),
+    _flag(0),
+    _expire(0) {
 
-uint32_t TimerSlot::GetLeftInterval() { 
-    return _left_interval; 
 }
 
-void TimerSlot::ResetTime() {
-    _left_interval = _total_interval;
-    _cur_index = 0;
+void TimerSlot::SetInterval(uint32_t interval) {
+    _total_interval = interval;
+    _flag = 0;
 }
 
-uint32_t TimerSlot::TimePass(uint32_t time) {
-    _left_interval -= time;
-    return _left_interval;
+uint32_t TimerSlot::GetTotalInterval() {
+    return _total_interval;
 }
 
 void TimerSlot::SetInTimer() {
-    _total_interval |= TSF_IN_TIMER;
+    _flag |= TSF_IN_TIMER;
 }
 
 bool TimerSlot::IsInTimer() {
-    return _total_interval & TSF_IN_TIMER;
+    return _flag & TSF_IN_TIMER;
 }
 
 void TimerSlot::RmInTimer() {
-    _total_interval &= ~TSF_IN_TIMER;
+    _flag &= ~TSF_IN_TIMER;
 }
 
 void TimerSlot::SetAlways() {
-    _total_interval |= TSF_ALWAYS;
+    _flag |= TSF_ALWAYS;
 }
 
 bool TimerSlot::IsAlways() {
-    return _total_interval & TSF_ALWAYS;
+    return _flag & TSF_ALWAYS;
 }
 
 void TimerSlot::RmAlways() {
-    _total_interval &= ~TSF_ALWAYS;
+    _flag &= ~TSF_ALWAYS;
 }
 
-void TimerSlot::SetCurIndex(uint16_t index, uint16_t type) {
-    _cur_index = index | type;
 }
-
-void TimerSlot::GetCurIndex(uint16_t& index, uint16_t& type) {
-    index = _cur_index & ~TIT_MUSK;
-    type = _cur_index & TIT_MUSK;
-}
-
-}
\ No newline at end of file
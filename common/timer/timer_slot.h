@@ -6,31 +6,49 @@
 #ifndef COMMON_TIMER_TIMER_SLOT
 #define COMMON_TIMER_TIMER_SLOT
 
+#include <memory>
 #include <cstdint>
 #include "common/timer/timer_interface.h"
 
 namespace cppnet {
 
-enum TIME_INDEX_TYPE: uint16_t {
-    TIT_MILLISECOND = 0x01 << 10,
-    TIT_SECOND      = 0x02 << 10,
-    TIT_MINUTE      = 0x04 << 10,
-    TIT_MUSK        = 0x07 << 10,
+// link of timer wheel bucket list. the list is circular,
+// the head of bucket links to itself when empty.
+class TimerNode {
+public:
+    TimerNode(): _prev(this), _next(this) {}
+    // slot is taken out of timer when destroyed
+    ~TimerNode() { Unlink(); }
+
+    TimerNode(const TimerNode&) = delete;
+    TimerNode& operator=(const TimerNode&) = delete;
+
+    bool IsLinked() { return _next != this; }
+    void Unlink();
+    // link self before node
+    void LinkBefore(TimerNode* node);
+
+private:
+    friend class TimerContainer;
+
+    TimerNode* _prev;
+    TimerNode* _next;
 };
 
 // Inherit this class to add to timer.
-// don't call any function in this class, 
+// don't call any function in this class,
 // they internal used by timer.
-class TimerSlot {
+class TimerSlot:
+    public TimerNode {
 public:
     TimerSlot();
     ~TimerSlot() {}
 
 //private:
 public:
-    enum TIMER_SOLT_FLAG: uint32_t {
-        TSF_IN_TIMER = (uint32_t)1 << 30,
-        TSF_ALWAYS   = (uint32_t)1 << 31,
+    enum TIMER_SOLT_FLAG: uint8_t {
+        TSF_IN_TIMER = 0x01,
+        TSF_ALWAYS   = 0x02,
     };
 
     // timer out call back
@@ -38,10 +56,9 @@ public:
 
     void SetInterval(uint32_t interval);
     uint32_t GetTotalInterval();
-    uint32_t GetLeftInterval();
 
-    void ResetTime();
-    uint32_t TimePass(uint32_t time);
+    void SetSlack(uint32_t slack) { _slack = slack; }
+    uint32_t GetSlack() { return _slack; }
 
     void SetInTimer();
     bool IsInTimer();
@@ -51,18 +68,21 @@ public:
     bool IsAlways();
     void RmAlways();
 
-    void SetCurIndex(uint16_t index, uint16_t type);
-    void GetCurIndex(uint16_t& index, uint16_t& type);
-
 private:
     friend class TimerContainer;
 
     uint32_t _total_interval;
-    uint32_t _left_interval;
-
-    uint16_t _cur_index;
+    uint32_t _slack;
+    // wheel level and bucket index
+    uint16_t _index;
+    uint8_t  _level;
+    uint8_t  _flag;
+    // absolute expire time of timer wheel
+    uint64_t _expire;
+    // keep slot alive in call back
+    std::weak_ptr<TimerSlot> _self;
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,131 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+
+#include "common/log/log.h"
+#include "common/tls/tls_handle.h"
+#include "common/tls/tls_context.h"
+
+namespace cppnet {
+
+static const char* TlsErrorInfo() {
+    return ERR_error_string(ERR_get_error(), nullptr);
+}
+
+TlsContext::TlsContext():
+    _server(false),
+    _ctx(nullptr) {
+
+}
+
+TlsContext::~TlsContext() {
+    if (_ctx) {
+        SSL_CTX_free(_ctx);
+    }
+}
+
+bool TlsContext::InitServer(const std::string& cert_file, const std::string& key_file) {
+    if (!Init(true)) {
+        return false;
+    }
+
+    if (SSL_CTX_use_certificate_chain_file(_ctx, cert_file.c_str()) != 1) {
+        LOG_ERROR("load tls certificate failed. file:%s, info:%s", cert_file.c_str(), TlsErrorInfo());
+        return false;
+    }
+    if (SSL_CTX_use_PrivateKey_file(_ctx, key_file.c_str(), SSL_FILETYPE_PEM) != 1) {
+        LOG_ERROR("load tls private key failed. file:%s, info:%s", key_file.c_str(), TlsErrorInfo());
+        return false;
+    }
+    if (SSL_CTX_check_private_key(_ctx) != 1) {
+        LOG_ERROR("tls private key does not match certificate. info:%s", TlsErrorInfo());
+        return false;
+    }
+
+    // TLS 1.3 tickets are post handshake records, they can't be
+    // read by a plain readv after receive offload. don't send them.
+    SSL_CTX_set_num_tickets(_ctx, 0);
+    return true;
+}
+
+bool TlsContext::InitClient(const std::string& ca_file) {
+    if (!Init(false)) {
+        return false;
+    }
+
+    if (ca_file.empty()) {
+        SSL_CTX_set_verify(_ctx, SSL_VERIFY_NONE, nullptr);
+        return true;
+    }
+
+    if (SSL_CTX_load_verify_locations(_ctx, ca_file.c_str(), nullptr) != 1) {
+        LOG_ERROR("load tls ca file failed. file:%s, info:%s", ca_file.c_str(), TlsErrorInfo());
+        return false;
+    }
+    SSL_CTX_set_verify(_ctx, SSL_VERIFY_PEER, nullptr);
+    return true;
+}
+
+std::shared_ptr<TlsHandle> TlsContext::NewHandle(uint64_t sock) {
+    SSL* ssl = SSL_new(_ctx);
+    if (!ssl) {
+        LOG_ERROR("create tls session failed. info:%s", TlsErrorInfo());
+        return nullptr;
+    }
+
+    if (SSL_set_fd(ssl, (int)sock) != 1) {
+        LOG_ERROR("bind tls session to socket failed. socket:%llu, info:%s", (unsigned long long)sock, TlsErrorInfo());
+        SSL_free(ssl);
+        return nullptr;
+    }
+
+    if (_server) {
+        SSL_set_accept_state(ssl);
+
+    } else {
+        SSL_set_connect_state(ssl);
+    }
+    return std::make_shared<TlsHandle>(ssl, _server);
+}
+
+bool TlsContext::Init(bool server) {
+    if (_ctx) {
+        return false;
+    }
+
+    _ctx = SSL_CTX_new(TLS_method());
+    if (!_ctx) {
+        LOG_ERROR("create tls context failed. info:%s", TlsErrorInfo());
+        return false;
+    }
+    _server = server;
+
+    SSL_CTX_set_min_proto_version(_ctx, TLS1_2_VERSION);
+    // openssl sets TCP_ULP "tls" after handshake if the kernel supports it
+    SSL_CTX_set_options(_ctx, SSL_OP_ENABLE_KTLS);
+    // buffer queue may return less data or move memory between two retries
+    SSL_CTX_set_mode(_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+    return true;
+}
+
+std::shared_ptr<TlsContext> MakeServerTlsContext(const std::string& cert_file, const std::string& key_file) {
+    auto ctx = std::make_shared<TlsContext>();
+    if (!ctx->InitServer(cert_file, key_file)) {
+        return nullptr;
+    }
+    return ctx;
+}
+
+std::shared_ptr<TlsContext> MakeClientTlsContext(const std::string& ca_file) {
+    auto ctx = std::make_shared<TlsContext>();
+    if (!ctx->InitClient(ca_file)) {
+        return nullptr;
+    }
+    return ctx;
+}
+
+}
@@ -0,0 +1,50 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_TLS_TLS_CONTEXT
+#define COMMON_TLS_TLS_CONTEXT
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+typedef struct ssl_ctx_st SSL_CTX;
+
+namespace cppnet {
+
+class TlsHandle;
+// wrap of openssl SSL_CTX. one context is shared by all
+// connections of a listener, or by all client connections.
+// kernel TLS is requested on every context, if the kernel
+// can't offload the record layer, the handle falls back to openssl.
+class TlsContext {
+public:
+    TlsContext();
+    ~TlsContext();
+
+    // load certificate chain and private key in PEM format.
+    bool InitServer(const std::string& cert_file, const std::string& key_file);
+    // if ca_file is not empty, peer certificate will be verified.
+    bool InitClient(const std::string& ca_file = "");
+
+    bool IsServer() { return _server; }
+
+    // create a tls handle for the connected socket.
+    std::shared_ptr<TlsHandle> NewHandle(uint64_t sock);
+
+private:
+    bool Init(bool server);
+
+private:
+    bool     _server;
+    SSL_CTX* _ctx;
+};
+
+std::shared_ptr<TlsContext> MakeServerTlsContext(const std::string& cert_file, const std::string& key_file);
+std::shared_ptr<TlsContext> MakeClientTlsContext(const std::string& ca_file = "");
+
+}
+
+#endif
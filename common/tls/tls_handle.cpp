@@ -0,0 +1,161 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <errno.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+
+#include "common/log/log.h"
+#include "common/tls/tls_handle.h"
+
+namespace cppnet {
+
+TlsHandle::TlsHandle(SSL* ssl, bool server):
+    _ssl(ssl),
+    _server(server),
+    _handshake_done(false),
+    _kernel_send(false),
+    _kernel_recv(false) {
+
+}
+
+TlsHandle::~TlsHandle() {
+    if (_ssl) {
+        SSL_free(_ssl);
+    }
+}
+
+TlsStatus TlsHandle::Handshake() {
+    if (_handshake_done) {
+        return TS_DONE;
+    }
+
+    ERR_clear_error();
+    int32_t ret = SSL_do_handshake(_ssl);
+    if (ret == 1) {
+        _handshake_done = true;
+        _kernel_send = BIO_get_ktls_send(SSL_get_wbio(_ssl));
+        _kernel_recv = BIO_get_ktls_recv(SSL_get_rbio(_ssl));
+        LOG_DEBUG("tls handshake done. version:%s, kernel send:%d, kernel recv:%d",
+            SSL_get_version(_ssl), _kernel_send, _kernel_recv);
+        return TS_DONE;
+    }
+
+    switch (SSL_get_error(_ssl, ret))
+    {
+    case SSL_ERROR_WANT_READ:
+        return TS_WANT_READ;
+    case SSL_ERROR_WANT_WRITE:
+        return TS_WANT_WRITE;
+    default:
+        LOG_ERROR("tls handshake failed. errno:%d, info:%s", errno, ERR_error_string(ERR_get_error(), nullptr));
+        return TS_ERROR;
+    }
+}
+
+SysCallInt32Result TlsHandle::Readv(int64_t sockfd, Iovec *vec, uint32_t vec_len) {
+    if (_kernel_recv) {
+        auto ret = OsHandle::Readv(sockfd, vec, vec_len);
+        // a control record is at the head of socket queue,
+        // after handshake it can only be an alert. peer is closing.
+        if (ret._return_value < 0 && ret._errno == EIO) {
+            return {0, 0};
+        }
+        return ret;
+    }
+
+    ERR_clear_error();
+    int32_t total = 0;
+    for (uint32_t i = 0; i < vec_len; i++) {
+        char* base = (char*)vec[i]._iov_base;
+        int32_t len = (int32_t)vec[i]._iov_len;
+        int32_t done = 0;
+        while (done < len) {
+            int32_t ret = SSL_read(_ssl, base + done, len - done);
+            if (ret > 0) {
+                done += ret;
+                continue;
+            }
+
+            total += done;
+            int32_t err = SSL_get_error(_ssl, ret);
+            if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+                if (total > 0) {
+                    return {total, 0};
+                }
+                errno = EAGAIN;
+                return {-1, EAGAIN};
+            }
+
+            // close notify, or socket closed without it
+            if (err == SSL_ERROR_ZERO_RETURN || (err == SSL_ERROR_SYSCALL && errno == 0)) {
+                return {total, 0};
+            }
+
+            if (total > 0) {
+                return {total, 0};
+            }
+            if (err != SSL_ERROR_SYSCALL) {
+                errno = EBADMSG;
+            }
+            return {-1, errno};
+        }
+        total += done;
+    }
+    return {total, 0};
+}
+
+SysCallInt32Result TlsHandle::Writev(int64_t sockfd, Iovec *vec, uint32_t vec_len) {
+    if (_kernel_send) {
+        return OsHandle::Writev(sockfd, vec, vec_len);
+    }
+
+    ERR_clear_error();
+    int32_t total = 0;
+    for (uint32_t i = 0; i < vec_len; i++) {
+        const char* base = (const char*)vec[i]._iov_base;
+        int32_t len = (int32_t)vec[i]._iov_len;
+        int32_t done = 0;
+        while (done < len) {
+            // partial write is enabled, return after every record
+            int32_t ret = SSL_write(_ssl, base + done, len - done);
+            if (ret > 0) {
+                done += ret;
+                continue;
+            }
+
+            total += done;
+            int32_t err = SSL_get_error(_ssl, ret);
+            if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+                if (total > 0) {
+                    return {total, 0};
+                }
+                errno = EAGAIN;
+                return {-1, EAGAIN};
+            }
+
+            if (total > 0) {
+                return {total, 0};
+            }
+            if (err != SSL_ERROR_SYSCALL || errno == 0) {
+                errno = EBADMSG;
+            }
+            return {-1, errno};
+        }
+        total += done;
+    }
+    return {total, 0};
+}
+
+void TlsHandle::Shutdown() {
+    if (!_handshake_done) {
+        return;
+    }
+    // only send close notify, never wait for peer's
+    SSL_shutdown(_ssl);
+    ERR_clear_error();
+}
+
+}
@@ -0,0 +1,58 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_TLS_TLS_HANDLE
+#define COMMON_TLS_TLS_HANDLE
+
+#include <cstdint>
+#include "common/util/os_return.h"
+#include "common/network/io_handle.h"
+
+typedef struct ssl_st SSL;
+
+namespace cppnet {
+
+enum TlsStatus {
+    TS_DONE       = 0, // handshake finished
+    TS_WANT_READ  = 1, // wait socket readable
+    TS_WANT_WRITE = 2, // wait socket writable
+    TS_ERROR      = 3, // handshake failed
+};
+
+// tls session of one connection.
+// handshake runs in user space. after that, if the kernel accepted
+// the TLS ULP, Readv and Writev go to the socket directly and
+// the record layer is done by the kernel, otherwise by openssl.
+// return value and errno of Readv and Writev are the same as OsHandle.
+class TlsHandle {
+public:
+    TlsHandle(SSL* ssl, bool server);
+    ~TlsHandle();
+
+    TlsStatus Handshake();
+    bool IsHandshakeDone() { return _handshake_done; }
+    bool IsServer() { return _server; }
+
+    // record layer is offloaded to kernel
+    bool IsKernelSend() { return _kernel_send; }
+    bool IsKernelRecv() { return _kernel_recv; }
+
+    SysCallInt32Result Readv(int64_t sockfd, Iovec *vec, uint32_t vec_len);
+    SysCallInt32Result Writev(int64_t sockfd, Iovec *vec, uint32_t vec_len);
+
+    // send close notify, don't wait peer's.
+    void Shutdown();
+
+private:
+    SSL* _ssl;
+    bool _server;
+    bool _handshake_done;
+    bool _kernel_send;
+    bool _kernel_recv;
+};
+
+}
+
+#endif
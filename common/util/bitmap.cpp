@@ -3,7 +3,9 @@
 
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
-#include <cmath>
+#ifdef __win__
+#include <intrin.h>
+#endif
 #include "common/util/bitmap.h"
 
 namespace cppnet {
@@ -11,6 +13,17 @@ namespace cppnet {
 static const uint32_t __step_size = sizeof(int64_t) * 8;
 static const uint64_t __setp_base = 1;
 
+// index of the lowest 1 bit, value must not be 0
+static uint32_t LowestBit(uint64_t value) {
+#ifdef __win__
+    unsigned long index = 0;
+    _BitScanForward64(&index, value);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(value);
+#endif
+}
+
 Bitmap::Bitmap():
     _vec_bitmap(0) {
 
@@ -37,7 +50,7 @@ bool Bitmap::Init(uint32_t size) {
 }
 
 bool Bitmap::Insert(uint32_t index) {
-    if (index > _bitmap.size() * __step_size) {
+    if (index >= _bitmap.size() * __step_size) {
         return false;
     }
 
@@ -53,7 +66,7 @@ bool Bitmap::Insert(uint32_t index) {
 }
 
 bool Bitmap::Remove(uint32_t index) {
-    if (index > _bitmap.size() * __step_size) {
+    if (index >= _bitmap.size() * __step_size) {
         return false;
     }
 
@@ -77,51 +90,26 @@ int32_t Bitmap::GetMinAfter(uint32_t index) {
 
     // get index in vector
     uint32_t bitmap_index = index / __step_size;
-    // filter smaller bitmap index
-    uint32_t ret = bitmap_index * __step_size;
+    // get index in uint64_t
+    uint32_t bit_index = index % __step_size;
 
     // find current uint64_t have next 1?
-    if (_bitmap[bitmap_index] != 0) {
-        int64_t cur_bitmap = _bitmap[bitmap_index];
-        int32_t cur_step = index - ret;
-        cur_bitmap = cur_bitmap >> cur_step;
-
-        // don't have next 1
-        if (cur_bitmap == 0) {
-            ret += __step_size;
-
-        // find next 1
-        } else {
-            ret += cur_step;
-            ret += (uint32_t)std::log2f(float(cur_bitmap & (-cur_bitmap)));
-            return ret;
-        }
-
-    } else {
-        ret += __step_size;
-    }
-
-    // find next used vector index 
-    int32_t temp_vec_bitmap = _vec_bitmap >> bitmap_index;
-    if (temp_vec_bitmap == 0) {
-        return -1;
+    uint64_t cur_bitmap = (uint64_t)_bitmap[bitmap_index] >> bit_index;
+    if (cur_bitmap != 0) {
+        return index + LowestBit(cur_bitmap);
     }
 
-    uint32_t next_vec_index = (uint32_t)std::log2f(float((temp_vec_bitmap & (-temp_vec_bitmap)) + 1));
-    uint32_t target_vec_index = next_vec_index + bitmap_index;
-    if (target_vec_index == bitmap_index) {
+    // find next used vector index
+    if (bitmap_index + 1 >= sizeof(_vec_bitmap) * 8) {
         return -1;
     }
-    
-    if (target_vec_index >= _bitmap.size()) {
+    uint32_t next_vec_bitmap = _vec_bitmap >> (bitmap_index + 1);
+    if (next_vec_bitmap == 0) {
         return -1;
     }
-    
-    int64_t cur_bitmap = _bitmap[target_vec_index];
-    ret += (next_vec_index - 1) * __step_size;
-    ret += (uint32_t)std::log2f(float((cur_bitmap & (-cur_bitmap)) + 1));
 
-    return ret;
+    uint32_t target_vec_index = bitmap_index + 1 + LowestBit(next_vec_bitmap);
+    return target_vec_index * __step_size + LowestBit((uint64_t)_bitmap[target_vec_index]);
 }
 
 bool Bitmap::Empty() {
@@ -130,8 +118,7 @@ bool Bitmap::Empty() {
 
 void Bitmap::Clear() {
     while (_vec_bitmap != 0) {
-        int32_t next_vec_index = (int32_t)std::log2f(float((_vec_bitmap & (-(int32_t)_vec_bitmap)) + 1));
-        _bitmap[next_vec_index] = 0;
+        _bitmap[LowestBit(_vec_bitmap)] = 0;
         _vec_bitmap = _vec_bitmap & (_vec_bitmap - 1);
     }
 }
@@ -0,0 +1,128 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include <cstring>
+// 32 bits builds may have no sse2, use memchr and memcmp there
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define __find_use_sse2__
+#if defined(__GNUC__) && !defined(__win__)
+#define __find_use_avx2__
+#endif
+#endif
+#ifdef __win__
+#include <intrin.h>
+#endif
+
+#include "common/util/find_str.h"
+
+namespace cppnet {
+
+// index of the lowest 1 bit, value must not be 0
+static inline uint32_t LowestBit(uint32_t value) {
+#ifdef __win__
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz(value);
+#endif
+}
+
+// check positions from start one by one
+static const char* FindStrScalar(const char* buffer, uint32_t buffer_len, const char* s, uint32_t s_len, uint32_t start) {
+    if (buffer_len < s_len + start) {
+        return nullptr;
+    }
+    const char* cur = buffer + start;
+    const char* last = buffer + buffer_len - s_len;
+    while (cur <= last) {
+        cur = (const char*)memchr(cur, *s, last - cur + 1);
+        if (!cur) {
+            return nullptr;
+        }
+        if (memcmp(cur + 1, s + 1, s_len - 1) == 0) {
+            return cur;
+        }
+        cur++;
+    }
+    return nullptr;
+}
+
+#ifdef __find_use_sse2__
+static const char* FindStrSSE2(const char* buffer, uint32_t buffer_len, const char* s, uint32_t s_len) {
+    const __m128i first = _mm_set1_epi8(s[0]);
+    const __m128i last = _mm_set1_epi8(s[s_len - 1]);
+
+    uint32_t i = 0;
+    for (; i + s_len - 1 + 16 <= buffer_len; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(buffer + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*)(buffer + i + s_len - 1));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+            _mm_cmpeq_epi8(last, block_last)));
+
+        while (mask) {
+            uint32_t pos = i + LowestBit(mask);
+            if (s_len <= 2 || memcmp(buffer + pos + 1, s + 1, s_len - 2) == 0) {
+                return buffer + pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return FindStrScalar(buffer, buffer_len, s, s_len, i);
+}
+#endif
+
+#ifdef __find_use_avx2__
+__attribute__((target("avx2")))
+static const char* FindStrAVX2(const char* buffer, uint32_t buffer_len, const char* s, uint32_t s_len) {
+    const __m256i first = _mm256_set1_epi8(s[0]);
+    const __m256i last = _mm256_set1_epi8(s[s_len - 1]);
+
+    uint32_t i = 0;
+    for (; i + s_len - 1 + 32 <= buffer_len; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i*)(buffer + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i*)(buffer + i + s_len - 1));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+            _mm256_cmpeq_epi8(last, block_last)));
+
+        while (mask) {
+            uint32_t pos = i + LowestBit(mask);
+            if (s_len <= 2 || memcmp(buffer + pos + 1, s + 1, s_len - 2) == 0) {
+                return buffer + pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return FindStrSSE2(buffer + i, buffer_len - i, s, s_len);
+}
+
+static bool CpuSupportAVX2() {
+    static const bool support = __builtin_cpu_supports("avx2");
+    return support;
+}
+#endif
+
+const char* FindStrInMem(const char* buffer, uint32_t buffer_len, const char* s, uint32_t s_len) {
+    if (!buffer || !s || s_len == 0 || buffer_len < s_len) {
+        return nullptr;
+    }
+    if (s_len == 1) {
+        return (const char*)memchr(buffer, *s, buffer_len);
+    }
+
+#ifdef __find_use_avx2__
+    if (CpuSupportAVX2()) {
+        return FindStrAVX2(buffer, buffer_len, s, s_len);
+    }
+#endif
+#ifdef __find_use_sse2__
+    return FindStrSSE2(buffer, buffer_len, s, s_len);
+#else
+    return FindStrScalar(buffer, buffer_len, s, s_len, 0);
+#endif
+}
+
+}
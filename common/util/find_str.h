@@ -0,0 +1,21 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_UTIL_FIND_STR
+#define COMMON_UTIL_FIND_STR
+
+#include <cstdint>
+
+namespace cppnet {
+
+// find s in buffer. return the first position if find otherwise return nullptr.
+// candidates are found by comparing the first and the last byte of s with
+// AVX2 or SSE2, 32 or 16 positions at once. AVX2 is used if cpu supports.
+// scalar memchr and memcmp on other platforms.
+const char* FindStrInMem(const char* buffer, uint32_t buffer_len, const char* s, uint32_t s_len);
+
+}
+
+#endif
@@ -0,0 +1,61 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include "include/cppnet_type.h"
+#include "common/util/memory_counter.h"
+
+namespace cppnet {
+
+MemoryCounter::MemoryCounter():
+    _limit(0),
+    _policy(CMP_STOP_READ),
+    _used(0),
+    _connections(0) {
+
+    for (uint16_t i = 0; i < 3; i++) {
+        _shed[i] = 0;
+    }
+}
+
+void MemoryCounter::SetLimit(uint64_t limit, uint16_t policy) {
+    if (policy > CMP_CLOSE_LARGEST) {
+        policy = CMP_STOP_READ;
+    }
+    _policy = policy;
+    _limit = limit;
+}
+
+uint64_t MemoryCounter::GetUsed() {
+    int64_t used = _used.load(std::memory_order_relaxed);
+    return used > 0 ? (uint64_t)used : 0;
+}
+
+uint64_t MemoryCounter::GetAverage() {
+    uint32_t connections = GetConnections();
+    if (connections == 0) {
+        return GetUsed();
+    }
+    return GetUsed() / connections;
+}
+
+bool MemoryCounter::IsOverLimit(uint16_t policy) {
+    uint64_t limit = _limit.load(std::memory_order_relaxed);
+    return limit > 0 && _policy.load(std::memory_order_relaxed) == policy && GetUsed() >= limit;
+}
+
+void MemoryCounter::AddShed(uint16_t policy) {
+    if (policy <= CMP_CLOSE_LARGEST) {
+        _shed[policy].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t MemoryCounter::GetShed(uint16_t policy) {
+    if (policy > CMP_CLOSE_LARGEST) {
+        return 0;
+    }
+    return _shed[policy].load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,54 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_UTIL_MEMORY_COUNTER
+#define COMMON_UTIL_MEMORY_COUNTER
+
+#include <atomic>
+#include <cstdint>
+
+namespace cppnet {
+
+// count bytes held by buffers of connections and number of connections.
+// thread safe, one counter is shared by connections on all dispatchers.
+// when a limit is set, the caller applies the policy if IsOverLimit.
+class MemoryCounter {
+public:
+    MemoryCounter();
+    ~MemoryCounter() {}
+
+    // limit: bytes, 0 means no limit.
+    void SetLimit(uint64_t limit, uint16_t policy);
+    uint64_t GetLimit() { return _limit; }
+    uint16_t GetPolicy() { return _policy; }
+
+    // len may be negative when buffers shrink
+    void Add(int64_t len) { _used.fetch_add(len, std::memory_order_relaxed); }
+    uint64_t GetUsed();
+
+    void AddConnection() { _connections.fetch_add(1, std::memory_order_relaxed); }
+    void RemoveConnection() { _connections.fetch_sub(1, std::memory_order_relaxed); }
+    uint32_t GetConnections() { return _connections.load(std::memory_order_relaxed); }
+    // bytes per connection
+    uint64_t GetAverage();
+
+    bool IsOverLimit(uint16_t policy);
+
+    // count times the policy is applied
+    void AddShed(uint16_t policy);
+    uint64_t GetShed(uint16_t policy);
+
+private:
+    std::atomic<uint64_t> _limit;
+    std::atomic<uint16_t> _policy;
+    // signed, moves of one connection may be seen out of order
+    std::atomic<int64_t>  _used;
+    std::atomic<uint32_t> _connections;
+    std::atomic<uint64_t> _shed[3];
+};
+
+}
+
+#endif
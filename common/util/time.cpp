@@ -3,13 +3,54 @@
 
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
+#include <ctime>
 #include <chrono>
 #include <thread>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#ifdef __linux__
+#include <time.h>
+#endif
 #include "time.h"
 #include "common/os/convert.h"
 
 namespace cppnet {
 
+// length of format time of every unit, FTU_MILLISECOND at last
+static const uint8_t __format_time_len[] = {23, 4, 7, 10, 13, 16, 19, 23};
+// position of milliseconds in format time
+static const uint8_t __format_time_msec_pos = 20;
+
+// buffer of time cache, holds format time and http date
+static const uint8_t __time_cache_buf_size = __format_time_buf_size > __http_date_buf_size ?
+    __format_time_buf_size : __http_date_buf_size;
+
+// last formatted second of the thread
+struct TimeCache {
+    uint64_t _sec;
+    char     _buf[__time_cache_buf_size];
+
+    TimeCache(): _sec(UINT64_MAX) {}
+};
+static thread_local TimeCache __format_time_cache;
+static thread_local TimeCache __http_date_cache;
+
+static const char* __week_days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char* __months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+static void CopyTime(const char* time, uint32_t size, char* buf, uint32_t& len) {
+    if (len == 0) {
+        return;
+    }
+    if (size > len - 1) {
+        size = len - 1;
+    }
+    memcpy(buf, time, size);
+    buf[size] = '\0';
+    len = size;
+}
+
 uint64_t UTCTimeSec() {
     return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
@@ -18,6 +59,40 @@ uint64_t UTCTimeMsec() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+uint64_t UTCTimeUsec() {
+#ifdef __linux__
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+#else
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+#endif
+}
+
+uint64_t SteadyTimeMsec() {
+    return SteadyTimeUsec() / 1000;
+}
+
+uint64_t SteadyTimeUsec() {
+#ifdef __linux__
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+#else
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+uint64_t CoarseSteadyTimeMsec() {
+#ifdef __linux__
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#else
+    return SteadyTimeMsec();
+#endif
+}
+
 std::string GetFormatTime(FormatTimeUnit unit) {
     char buf[__format_time_buf_size] = {0};
     uint32_t len = __format_time_buf_size;
@@ -27,48 +102,121 @@ std::string GetFormatTime(FormatTimeUnit unit) {
 }
 
 void GetFormatTime(char* buf, uint32_t& len, FormatTimeUnit unit) {
-    auto now_time = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now_time);
-    
-    int32_t millisecond = 0;
+    GetFormatTime(UTCTimeMsec(), buf, len, unit);
+}
+
+void GetFormatTime(uint64_t utc_msec, char* buf, uint32_t& len, FormatTimeUnit unit) {
+    uint64_t sec = utc_msec / 1000;
+    TimeCache& cache = __format_time_cache;
+    if (cache._sec != sec) {
+        tm time;
+        Localtime(&sec, (void*)&time);
+        // fields are clamped, so milliseconds are always at __format_time_msec_pos
+        snprintf(cache._buf, sizeof(cache._buf), "%04u-%02u-%02u:%02u:%02u:%02u:000", (uint32_t)(1900 + time.tm_year) % 10000,
+            (uint32_t)(1 + time.tm_mon) % 100, (uint32_t)time.tm_mday % 100, (uint32_t)time.tm_hour % 100,
+            (uint32_t)time.tm_min % 100, (uint32_t)time.tm_sec % 100);
+        cache._sec = sec;
+    }
+
+    if (unit < FTU_YEAR || unit > FTU_MILLISECOND) {
+        // default FTU_MILLISECOND
+        unit = FTU_MILLISECOND;
+    }
     if (unit == FTU_MILLISECOND) {
-        auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(now_time.time_since_epoch()).count();
-        auto sec = std::chrono::duration_cast<std::chrono::seconds>(now_time.time_since_epoch()).count();
-        millisecond = (int32_t)(msec - (sec * 1000));
+        uint32_t millisecond = (uint32_t)(utc_msec % 1000);
+        cache._buf[__format_time_msec_pos] = '0' + millisecond / 100;
+        cache._buf[__format_time_msec_pos + 1] = '0' + millisecond / 10 % 10;
+        cache._buf[__format_time_msec_pos + 2] = '0' + millisecond % 10;
     }
-    
+    CopyTime(cache._buf, __format_time_len[unit], buf, len);
+}
+
+void GetTimePeriod(uint64_t utc_msec, FormatTimeUnit unit, uint64_t& start, uint64_t& end) {
+    uint64_t sec = utc_msec / 1000;
     tm time;
-    Localtime((uint64_t*)&now_time_t, (void*)&time);
+    Localtime(&sec, (void*)&time);
+    // clear the fields under the unit, mktime fixes the overflow of the next one
     switch (unit)
     {
-    case FTU_MILLISECOND:
-        len = snprintf(buf, len, "%04d-%02d-%02d:%02d:%02d:%02d:%03d", 1900 + time.tm_year,  1 + time.tm_mon,  time.tm_mday,  time.tm_hour, time.tm_min, time.tm_sec, millisecond);
-        break;
-    case FTU_SECOND:
-        len = snprintf(buf, len, "%04d-%02d-%02d:%02d:%02d:%02d", 1900 + time.tm_year,  1 + time.tm_mon,  time.tm_mday,  time.tm_hour, time.tm_min, time.tm_sec);
-        break;
+    case FTU_YEAR:
+        time.tm_mon = 0;
+        // fall through
+    case FTU_MONTH:
+        time.tm_mday = 1;
+        // fall through
+    case FTU_DAY:
+        time.tm_hour = 0;
+        // fall through
+    case FTU_HOUR:
+        time.tm_min = 0;
+        // fall through
     case FTU_MINUTE:
-        len = snprintf(buf, len, "%04d-%02d-%02d:%02d:%02d", 1900 + time.tm_year,  1 + time.tm_mon,  time.tm_mday,  time.tm_hour, time.tm_min);
+        time.tm_sec = 0;
+    default:
         break;
-    case FTU_HOUR:
-        len = snprintf(buf, len, "%04d-%02d-%02d:%02d", 1900 + time.tm_year,  1 + time.tm_mon,  time.tm_mday,  time.tm_hour);
+    }
+
+    tm next = time;
+    switch (unit)
+    {
+    case FTU_YEAR:
+        next.tm_year++;
+        break;
+    case FTU_MONTH:
+        next.tm_mon++;
         break;
     case FTU_DAY:
-        len = snprintf(buf, len, "%04d-%02d-%02d", 1900 + time.tm_year,  1 + time.tm_mon,  time.tm_mday);
+        next.tm_mday++;
         break;
-    case FTU_MONTH:
-        len = snprintf(buf, len, "%04d-%02d", 1900 + time.tm_year,  1 + time.tm_mon);
+    case FTU_HOUR:
+        next.tm_hour++;
         break;
-    case FTU_YEAR:
-        len = snprintf(buf, len, "%04d", 1900 + time.tm_year);
+    case FTU_MINUTE:
+        next.tm_min++;
         break;
-    default:
-        // default FTU_MILLISECOND
-        len = snprintf(buf, len, "%04d-%02d-%02d:%02d:%02d:%02d:%03d", 1900 + time.tm_year,  1 + time.tm_mon,  time.tm_mday,  time.tm_hour, time.tm_min, time.tm_sec, millisecond);
+    case FTU_SECOND:
+        next.tm_sec++;
         break;
+    default:
+        start = utc_msec;
+        end = utc_msec + 1;
+        return;
+    }
+    tm start_tm = time;
+    tm end_tm = next;
+    start_tm.tm_isdst = -1;
+    end_tm.tm_isdst = -1;
+    start = (uint64_t)mktime(&start_tm) * 1000;
+    end = (uint64_t)mktime(&end_tm) * 1000;
+
+    // the hour is repeated when dst ends, use the offset of the time for both ends
+    if (utc_msec < start || utc_msec >= end) {
+        start = (uint64_t)mktime(&time) * 1000;
+        end = (uint64_t)mktime(&next) * 1000;
     }
 }
 
+std::string GetHttpDate() {
+    char buf[__http_date_buf_size] = {0};
+    uint32_t len = __http_date_buf_size;
+
+    GetHttpDate(buf, len);
+    return std::string(buf, len);
+}
+
+void GetHttpDate(char* buf, uint32_t& len) {
+    uint64_t sec = UTCTimeSec();
+    TimeCache& cache = __http_date_cache;
+    if (cache._sec != sec) {
+        tm time;
+        Gmtime(&sec, (void*)&time);
+        snprintf(cache._buf, sizeof(cache._buf), "%s, %02u %s %04u %02u:%02u:%02u GMT", __week_days[time.tm_wday % 7],
+            (uint32_t)time.tm_mday % 100, __months[time.tm_mon % 12], (uint32_t)(1900 + time.tm_year) % 10000,
+            (uint32_t)time.tm_hour % 100, (uint32_t)time.tm_min % 100, (uint32_t)time.tm_sec % 100);
+        cache._sec = sec;
+    }
+    CopyTime(cache._buf, __http_date_buf_size - 1, buf, len);
+}
 
 void Sleep(uint32_t interval) {
     std::this_thread::sleep_for(std::chrono::milliseconds(interval));
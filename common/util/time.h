@@ -11,6 +11,7 @@
 namespace cppnet {
 
 static const uint8_t __format_time_buf_size = sizeof("xxxx-xx-xx:xx:xx:xx:xxx");
+static const uint8_t __http_date_buf_size = sizeof("Sun, 06 Nov 1994 08:49:37 GMT");
 
 enum FormatTimeUnit {
     FTU_YEAR        = 1, // 2021
@@ -26,10 +27,27 @@ enum FormatTimeUnit {
 std::string GetFormatTime(FormatTimeUnit unit = FTU_MILLISECOND);
 // get format time string as [xxxx-xx-xx xx:xx:xx]
 void GetFormatTime(char* buf, uint32_t& len, FormatTimeUnit unit = FTU_MILLISECOND);
+// format the utc time in milliseconds.
+// every thread caches the formatted second, times in the same second only write milliseconds.
+void GetFormatTime(uint64_t utc_msec, char* buf, uint32_t& len, FormatTimeUnit unit = FTU_MILLISECOND);
+// local time period of the unit which the utc time is in, [start, end) in utc milliseconds
+void GetTimePeriod(uint64_t utc_msec, FormatTimeUnit unit, uint64_t& start, uint64_t& end);
+
+// get time for http Date header as [Sun, 06 Nov 1994 08:49:37 GMT], cached every second
+std::string GetHttpDate();
+void GetHttpDate(char* buf, uint32_t& len);
 
 // get utc time
 uint64_t UTCTimeSec();
 uint64_t UTCTimeMsec();
+uint64_t UTCTimeUsec();
+
+// get monotonic time, not changed by setting system time.
+// same clock as CLOCK_MONOTONIC on linux.
+uint64_t SteadyTimeMsec();
+uint64_t SteadyTimeUsec();
+// cheaper monotonic time with precision of a few milliseconds
+uint64_t CoarseSteadyTimeMsec();
 
 // sleep interval milliseconds
 void Sleep(uint32_t interval);
@@ -0,0 +1,79 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include "common/util/time.h"
+#include "common/util/token_bucket.h"
+
+namespace cppnet {
+
+TokenBucket::TokenBucket(uint32_t rate, uint32_t burst):
+    _rate(0),
+    _burst(0),
+    _tokens(0),
+    _last_time(SteadyTimeMsec()) {
+
+    SetRate(rate, burst);
+    // start with a full bucket
+    _tokens = (int64_t)_burst * 1000;
+}
+
+void TokenBucket::SetRate(uint32_t rate, uint32_t burst) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _rate = rate;
+    _burst = burst > 0 ? burst : rate;
+    if (_tokens > (int64_t)_burst * 1000) {
+        _tokens = (int64_t)_burst * 1000;
+    }
+}
+
+uint32_t TokenBucket::GetRate() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _rate;
+}
+
+uint32_t TokenBucket::Available(uint64_t now) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_rate == 0) {
+        return UINT32_MAX;
+    }
+    Refill(now);
+    return _tokens > 0 ? (uint32_t)(_tokens / 1000) : 0;
+}
+
+void TokenBucket::Consume(uint32_t len) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _tokens -= (int64_t)len * 1000;
+}
+
+uint32_t TokenBucket::WaitTime(uint32_t len, uint64_t now) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_rate == 0) {
+        return 0;
+    }
+    Refill(now);
+    // the bucket never holds more than burst
+    if (len > _burst) {
+        len = _burst;
+    }
+    int64_t lack = (int64_t)len * 1000 - _tokens;
+    if (lack <= 0) {
+        return 0;
+    }
+    // round up, tokens of one millisecond are rate thousandths of a byte
+    return (uint32_t)((lack + _rate - 1) / _rate);
+}
+
+void TokenBucket::Refill(uint64_t now) {
+    if (now <= _last_time) {
+        return;
+    }
+    _tokens += (int64_t)(now - _last_time) * _rate;
+    _last_time = now;
+    if (_tokens > (int64_t)_burst * 1000) {
+        _tokens = (int64_t)_burst * 1000;
+    }
+}
+
+}
@@ -0,0 +1,49 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef COMMON_UTIL_TOKEN_BUCKET
+#define COMMON_UTIL_TOKEN_BUCKET
+
+#include <mutex>
+#include <cstdint>
+
+namespace cppnet {
+
+// token bucket rate limiter, one token is one byte.
+// thread safe, a listener's bucket is shared by connections
+// on all dispatchers.
+class TokenBucket {
+public:
+    // rate : bytes per second, 0 means no limit.
+    // burst: max bytes can be taken at once. 0 means same as rate.
+    TokenBucket(uint32_t rate, uint32_t burst = 0);
+    ~TokenBucket() {}
+
+    void SetRate(uint32_t rate, uint32_t burst = 0);
+    uint32_t GetRate();
+
+    // bytes can be sent at the millisecond time now, from SteadyTimeMsec
+    uint32_t Available(uint64_t now);
+    // take tokens after data sent. may overdraw when
+    // the bucket is shared, later callers will wait longer.
+    void Consume(uint32_t len);
+    // milliseconds to wait until len bytes can be sent
+    uint32_t WaitTime(uint32_t len, uint64_t now);
+
+private:
+    void Refill(uint64_t now);
+
+private:
+    std::mutex _mutex;
+    uint32_t   _rate;
+    uint32_t   _burst;
+    // in thousandths of a byte, so refill of every millisecond is exact
+    int64_t    _tokens;
+    uint64_t   _last_time;
+};
+
+}
+
+#endif
@@ -9,8 +9,11 @@
 
 #include "common/log/log.h"
 #include "common/util/random.h"
-#include "common/log/file_logger.h"
-#include "common/log/stdout_logger.h"
+#include "common/log/flight_recorder.h"
+#include "common/log/async_file_logger.h"
+#ifndef __win__
+#include <signal.h>
+#endif
 
 namespace cppnet {
 
@@ -31,14 +34,25 @@ void CppNet::Init(int32_t thread_num) {
     
     _cppnet_base->Init(thread_num);
     if (__print_log) {
-        std::shared_ptr<Logger> file_log = std::make_shared<FileLogger>(__log_file_name);
-        std::shared_ptr<Logger> std_log = std::make_shared<StdoutLogger>();
-        file_log->SetLogger(std_log);
+        // stdout is written by the writer thread, io threads take no lock
+        auto file_log = std::make_shared<AsyncFileLogger>(__log_file_name,
+            FLSU_DAY, 3, 5, __log_ring_size, __log_full_block ? LFP_BLOCK : LFP_DROP, __log_binary_file);
+        file_log->SetPrintStdout(__log_stdout);
         LOG_SET(file_log);
         LOG_SET_LEVEL((LogLevel)__log_level);
+        LOG_SET_DEFER_FORMAT(__log_defer_format || __log_binary_file);
     } else {
         LOG_SET_LEVEL(LL_NULL);
     }
+
+    if (__log_record_level != LL_NULL) {
+        auto recorder = std::make_shared<FlightRecorder>(__log_record_file, __log_record_slot_num);
+#ifndef __win__
+        recorder->DumpOnSignal(SIGUSR1);
+#endif
+        LOG_SET_RECORDER(recorder);
+        LOG_SET_RECORD_LEVEL((LogLevel)__log_record_level);
+    }
 }
 
 void CppNet::Destory() {
@@ -61,18 +75,38 @@ void CppNet::SetDisconnectionCallback(connect_call_back&& cb) {
     _cppnet_base->SetDisconnectionCallback(std::move(cb));
 }
 
+void CppNet::SetFrameCallback(frame_call_back&& cb) {
+    _cppnet_base->SetFrameCallback(std::move(cb));
+}
+
 void CppNet::SetTimerCallback(timer_call_back&& cb) {
     _cppnet_base->SetTimerCallback(std::move(cb));
 }
 
-uint64_t CppNet::AddTimer(int32_t interval, user_timer_call_back&& cb, void* param, bool always) {
-    return _cppnet_base->AddTimer(interval, std::move(cb), param, always);
+void CppNet::SetMemoryLimit(uint64_t limit, uint16_t policy) {
+    _cppnet_base->SetMemoryLimit(limit, policy);
+}
+
+bool CppNet::GetMemoryStat(MemoryStat& stat) {
+    return _cppnet_base->GetMemoryStat(stat);
+}
+
+uint64_t CppNet::AddTimer(int32_t interval, user_timer_call_back&& cb, void* param, bool always, uint32_t slack) {
+    return _cppnet_base->AddTimer(interval, std::move(cb), param, always, slack);
+}
+
+uint64_t CppNet::AddHighResTimer(uint64_t interval_us, user_timer_call_back&& cb, void* param, bool always) {
+    return _cppnet_base->AddHighResTimer(interval_us, std::move(cb), param, always);
 }
 
 void CppNet::RemoveTimer(uint64_t timer_id) {
     _cppnet_base->RemoveTimer(timer_id);
 }
 
+void CppNet::GetWakeupStat(std::vector<WakeupStat>& stats) {
+    _cppnet_base->GetWakeupStat(stats);
+}
+
 void CppNet::SetAcceptCallback(connect_call_back&& cb) {
     _cppnet_base->SetAcceptCallback(std::move(cb));
 }
@@ -81,6 +115,22 @@ bool CppNet::ListenAndAccept(const std::string& ip, uint16_t port) {
     return _cppnet_base->ListenAndAccept(ip, port);
 }
 
+void CppNet::SetListenSendRate(uint16_t port, uint32_t rate, uint32_t burst) {
+    _cppnet_base->SetListenSendRate(port, rate, burst);
+}
+
+void CppNet::SetListenMemoryLimit(uint16_t port, uint64_t limit, uint16_t policy) {
+    _cppnet_base->SetListenMemoryLimit(port, limit, policy);
+}
+
+bool CppNet::GetListenMemoryStat(uint16_t port, MemoryStat& stat) {
+    return _cppnet_base->GetListenMemoryStat(port, stat);
+}
+
+void CppNet::SetListenFrameDecoder(uint16_t port, std::shared_ptr<FrameDecoder> decoder) {
+    _cppnet_base->SetListenFrameDecoder(port, decoder);
+}
+
 void CppNet::SetConnectionCallback(connect_call_back&& cb) {
     _cppnet_base->SetConnectionCallback(std::move(cb));
 }
@@ -89,4 +139,12 @@ bool CppNet::Connection(const std::string& ip, uint16_t port) {
     return _cppnet_base->Connection(ip, port);
 }
 
+bool CppNet::ListenAndAcceptTls(const std::string& ip, uint16_t port, const std::string& cert_file, const std::string& key_file) {
+    return _cppnet_base->ListenAndAcceptTls(ip, port, cert_file, key_file);
+}
+
+bool CppNet::ConnectionTls(const std::string& ip, uint16_t port, const std::string& ca_file) {
+    return _cppnet_base->ConnectionTls(ip, port, ca_file);
+}
+
 } // namespace cppnet
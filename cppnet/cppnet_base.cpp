@@ -16,9 +16,14 @@
 #include "common/log/log.h"
 #include "common/os/os_info.h"
 #include "common/util/random.h"
+#include "common/util/token_bucket.h"
+#include "common/util/memory_counter.h"
 #include "common/network/socket.h"
 #include "common/network/io_handle.h"
 #include "common/buffer/buffer_queue.h"
+#ifdef __use_tls__
+#include "common/tls/tls_context.h"
+#endif
 
 namespace cppnet {
 
@@ -37,6 +42,7 @@ void CppNetBase::Init(uint32_t thread_num) {
         thread_num = cpus;
     }
     _random = std::unique_ptr<RangeRandom>(new RangeRandom(0, thread_num - 1));
+    _memory_counter = std::make_shared<MemoryCounter>();
 
 #ifndef __win__
     //Disable  SIGPIPE signal
@@ -64,9 +70,18 @@ void CppNetBase::Join() {
     }
 }
 
-uint64_t CppNetBase::AddTimer(uint32_t interval, user_timer_call_back&& cb, void* param, bool always) {
+uint64_t CppNetBase::AddTimer(uint32_t interval, user_timer_call_back&& cb, void* param, bool always, uint32_t slack) {
     uint32_t index = _random->Random();
-    uint32_t id = _dispatchers[index]->AddTimer(cb, param, interval, always);
+    uint32_t id = _dispatchers[index]->AddTimer(cb, param, interval, always, slack);
+    TimerId tid;
+    tid._detail_info._dispatcher_index = index;
+    tid._detail_info._timer_id = id;
+    return tid._timer_id;
+}
+
+uint64_t CppNetBase::AddHighResTimer(uint64_t interval_us, user_timer_call_back&& cb, void* param, bool always) {
+    uint32_t index = _random->Random();
+    uint32_t id = _dispatchers[index]->AddHighResTimer(cb, param, interval_us, always);
     TimerId tid;
     tid._detail_info._dispatcher_index = index;
     tid._detail_info._timer_id = id;
@@ -79,7 +94,16 @@ void CppNetBase::RemoveTimer(uint64_t timer_id) {
     _dispatchers[tid._detail_info._dispatcher_index]->StopTimer(tid._detail_info._timer_id);
 }
 
-bool CppNetBase::ListenAndAccept(const std::string& ip, uint16_t port) {
+void CppNetBase::GetWakeupStat(std::vector<WakeupStat>& stats) {
+    stats.resize(_dispatchers.size());
+    for (size_t i = 0; i < _dispatchers.size(); i++) {
+        _dispatchers[i]->GetWakeupStat(stats[i]);
+    }
+}
+
+bool CppNetBase::ListenAndAccept(const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context) {
+    // count memory of the port from the first connection
+    GetListenMemoryCounter(port);
 #ifdef __win__ // WEPOLL don't support reuse_port
     auto ret = OsHandle::TcpSocket(Address::IsIpv4(ip));
     if (ret._return_value < 0) {
@@ -87,7 +111,7 @@ bool CppNetBase::ListenAndAccept(const std::string& ip, uint16_t port) {
         return false;
     }
     for (size_t i = 0; i < _dispatchers.size(); i++) {
-        _dispatchers[i]->Listen(ret._return_value, ip, port);
+        _dispatchers[i]->Listen(ret._return_value, ip, port, tls_context);
     }
 #else
     if (__reuse_port) {
@@ -98,7 +122,7 @@ bool CppNetBase::ListenAndAccept(const std::string& ip, uint16_t port) {
                 return false;
             }
             ReusePort(ret._return_value);
-            _dispatchers[i]->Listen(ret._return_value, ip, port);
+            _dispatchers[i]->Listen(ret._return_value, ip, port, tls_context);
         }
 
     } else {
@@ -108,19 +132,152 @@ bool CppNetBase::ListenAndAccept(const std::string& ip, uint16_t port) {
             return false;
         }
         for (size_t i = 0; i < _dispatchers.size(); i++) {
-            _dispatchers[i]->Listen(ret._return_value, ip, port);
+            _dispatchers[i]->Listen(ret._return_value, ip, port, tls_context);
         }
     }
 #endif
     return true;
 }
 
-bool CppNetBase::Connection(const std::string& ip, uint16_t port) {
+void CppNetBase::SetListenSendRate(uint16_t port, uint32_t rate, uint32_t burst) {
+    std::unique_lock<std::mutex> lock(_limiter_mutex);
+    auto iter = _listen_send_limiter.find(port);
+    if (iter != _listen_send_limiter.end()) {
+        // connections accepted before hold the same bucket
+        iter->second->SetRate(rate, burst);
+        return;
+    }
+    if (rate > 0) {
+        _listen_send_limiter[port] = std::make_shared<TokenBucket>(rate, burst);
+    }
+}
+
+std::shared_ptr<TokenBucket> CppNetBase::GetListenSendLimiter(uint16_t port) {
+    std::unique_lock<std::mutex> lock(_limiter_mutex);
+    auto iter = _listen_send_limiter.find(port);
+    if (iter == _listen_send_limiter.end() || iter->second->GetRate() == 0) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+void CppNetBase::SetMemoryLimit(uint64_t limit, uint16_t policy) {
+    _memory_counter->SetLimit(limit, policy);
+}
+
+void CppNetBase::SetListenMemoryLimit(uint16_t port, uint64_t limit, uint16_t policy) {
+    // connections accepted before hold the same counter
+    GetListenMemoryCounter(port)->SetLimit(limit, policy);
+}
+
+static void GetCounterStat(std::shared_ptr<MemoryCounter>& counter, MemoryStat& stat) {
+    stat._used_bytes = counter->GetUsed();
+    stat._limit_bytes = counter->GetLimit();
+    stat._policy = counter->GetPolicy();
+    stat._connections = counter->GetConnections();
+    stat._stopped_reads = counter->GetShed(CMP_STOP_READ);
+    stat._rejected_writes = counter->GetShed(CMP_REJECT_WRITE);
+    stat._closed_connections = counter->GetShed(CMP_CLOSE_LARGEST);
+}
+
+bool CppNetBase::GetMemoryStat(MemoryStat& stat) {
+    if (!_memory_counter) {
+        return false;
+    }
+    GetCounterStat(_memory_counter, stat);
+    return true;
+}
+
+bool CppNetBase::GetListenMemoryStat(uint16_t port, MemoryStat& stat) {
+    std::shared_ptr<MemoryCounter> counter;
+    {
+        std::unique_lock<std::mutex> lock(_memory_mutex);
+        auto iter = _listen_memory_counter.find(port);
+        if (iter == _listen_memory_counter.end()) {
+            return false;
+        }
+        counter = iter->second;
+    }
+    GetCounterStat(counter, stat);
+    return true;
+}
+
+std::shared_ptr<MemoryCounter> CppNetBase::GetListenMemoryCounter(uint16_t port) {
+    std::unique_lock<std::mutex> lock(_memory_mutex);
+    auto& counter = _listen_memory_counter[port];
+    if (!counter) {
+        counter = std::make_shared<MemoryCounter>();
+    }
+    return counter;
+}
+
+void CppNetBase::SetListenFrameDecoder(uint16_t port, std::shared_ptr<FrameDecoder> decoder) {
+    std::unique_lock<std::mutex> lock(_decoder_mutex);
+    if (decoder) {
+        _listen_frame_decoder[port] = decoder;
+
+    } else {
+        _listen_frame_decoder.erase(port);
+    }
+}
+
+std::shared_ptr<FrameDecoder> CppNetBase::GetListenFrameDecoder(uint16_t port) {
+    std::unique_lock<std::mutex> lock(_decoder_mutex);
+    auto iter = _listen_frame_decoder.find(port);
+    if (iter == _listen_frame_decoder.end()) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+bool CppNetBase::Connection(const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context) {
     uint32_t index = _random->Random();
-    _dispatchers[index]->Connect(ip, port);
+    _dispatchers[index]->Connect(ip, port, tls_context);
     return true;
 }
 
+bool CppNetBase::ListenAndAcceptTls(const std::string& ip, uint16_t port, const std::string& cert_file, const std::string& key_file) {
+#ifdef __use_tls__
+    auto tls_context = MakeServerTlsContext(cert_file, key_file);
+    if (!tls_context) {
+        return false;
+    }
+    return ListenAndAccept(ip, port, tls_context);
+#else
+    (void)ip;
+    (void)cert_file;
+    (void)key_file;
+    LOG_ERROR("cppnet is built without tls support. port:%d", port);
+    return false;
+#endif
+}
+
+bool CppNetBase::ConnectionTls(const std::string& ip, uint16_t port, const std::string& ca_file) {
+#ifdef __use_tls__
+    std::shared_ptr<TlsContext> tls_context;
+    {
+        std::unique_lock<std::mutex> lock(_tls_mutex);
+        auto iter = _client_tls_context.find(ca_file);
+        if (iter != _client_tls_context.end()) {
+            tls_context = iter->second;
+
+        } else {
+            tls_context = MakeClientTlsContext(ca_file);
+            if (!tls_context) {
+                return false;
+            }
+            _client_tls_context[ca_file] = tls_context;
+        }
+    }
+    return Connection(ip, port, tls_context);
+#else
+    (void)ip;
+    (void)ca_file;
+    LOG_ERROR("cppnet is built without tls support. port:%d", port);
+    return false;
+#endif
+}
+
 void CppNetBase::OnTimer(std::shared_ptr<RWSocket> sock) {
     if (_timer_cb) {
         _timer_cb(sock);
@@ -139,6 +296,12 @@ void CppNetBase::OnRead(std::shared_ptr<RWSocket> sock, std::shared_ptr<InnerBuf
     }
 }
 
+void CppNetBase::OnFrame(std::shared_ptr<RWSocket> sock, const char* frame, uint32_t len) {
+    if (_frame_cb) {
+        _frame_cb(sock, frame, len);
+    }
+}
+
 void CppNetBase::OnWrite(std::shared_ptr<RWSocket> sock, uint32_t len) {
     if (_write_cb) {
         _write_cb(sock, len);
@@ -6,9 +6,11 @@
 #ifndef CPPNET_CPPNET_BASE
 #define CPPNET_CPPNET_BASE
 
+#include <mutex>
 #include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 #include "include/cppnet_type.h"
 
@@ -19,6 +21,10 @@ class RWSocket;
 class Dispatcher;
 class RangeRandom;
 class InnerBuffer;
+class TlsContext;
+class TokenBucket;
+class FrameDecoder;
+class MemoryCounter;
 
 class CppNetBase: 
     public std::enable_shared_from_this<CppNetBase> {
@@ -36,23 +42,45 @@ public:
     void SetWriteCallback(write_call_back&& cb) { _write_cb = std::move(cb); }
     void SetDisconnectionCallback(connect_call_back&& cb) { _disconnect_cb = std::move(cb); }
     void SetTimerCallback(timer_call_back&& cb) { _timer_cb = std::move(cb); }
+    void SetFrameCallback(frame_call_back&& cb) { _frame_cb = std::move(cb); }
 
     // about timer
-    uint64_t AddTimer(uint32_t interval, user_timer_call_back&& cb, void* param = nullptr, bool always = false);
+    uint64_t AddTimer(uint32_t interval, user_timer_call_back&& cb, void* param = nullptr, bool always = false, uint32_t slack = 0);
+    uint64_t AddHighResTimer(uint64_t interval_us, user_timer_call_back&& cb, void* param = nullptr, bool always = false);
     void RemoveTimer(uint64_t timer_id);
+    void GetWakeupStat(std::vector<WakeupStat>& stats);
 
     //server
     void SetAcceptCallback(connect_call_back&& cb) { _accept_cb = std::move(cb); }
-    bool ListenAndAccept(const std::string& ip, uint16_t port);
+    bool ListenAndAccept(const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context = nullptr);
+    void SetListenSendRate(uint16_t port, uint32_t rate, uint32_t burst = 0);
+    std::shared_ptr<TokenBucket> GetListenSendLimiter(uint16_t port);
+
+    // buffer memory of all connections and of each listen port
+    void SetMemoryLimit(uint64_t limit, uint16_t policy);
+    void SetListenMemoryLimit(uint16_t port, uint64_t limit, uint16_t policy);
+    bool GetMemoryStat(MemoryStat& stat);
+    bool GetListenMemoryStat(uint16_t port, MemoryStat& stat);
+    std::shared_ptr<MemoryCounter> GetMemoryCounter() { return _memory_counter; }
+    // create one if the port has no counter
+    std::shared_ptr<MemoryCounter> GetListenMemoryCounter(uint16_t port);
+
+    void SetListenFrameDecoder(uint16_t port, std::shared_ptr<FrameDecoder> decoder);
+    std::shared_ptr<FrameDecoder> GetListenFrameDecoder(uint16_t port);
 
     //client
     void SetConnectionCallback(connect_call_back&& cb) { _connect_cb = std::move(cb); }
-    bool Connection(const std::string& ip, uint16_t port);
+    bool Connection(const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context = nullptr);
+
+    // tls
+    bool ListenAndAcceptTls(const std::string& ip, uint16_t port, const std::string& cert_file, const std::string& key_file);
+    bool ConnectionTls(const std::string& ip, uint16_t port, const std::string& ca_file);
 
     // call back
     void OnTimer(std::shared_ptr<RWSocket> sock);
     void OnAccept(std::shared_ptr<RWSocket> sock);
     void OnRead(std::shared_ptr<RWSocket> sock, std::shared_ptr<InnerBuffer> buffer, uint32_t len);
+    void OnFrame(std::shared_ptr<RWSocket> sock, const char* frame, uint32_t len);
     void OnWrite(std::shared_ptr<RWSocket> sock, uint32_t len);
     void OnConnect(std::shared_ptr<RWSocket> sock, uint16_t err);
     void OnDisConnect(std::shared_ptr<RWSocket> sock, uint16_t err);
@@ -60,6 +88,7 @@ public:
 private:
     timer_call_back    _timer_cb;
     read_call_back     _read_cb;
+    frame_call_back    _frame_cb;
     write_call_back    _write_cb;
     connect_call_back  _connect_cb;
     connect_call_back  _disconnect_cb;
@@ -67,6 +96,23 @@ private:
 
     std::unique_ptr<RangeRandom> _random;
     std::vector<std::shared_ptr<Dispatcher>> _dispatchers;
+
+    // client tls context of each ca file
+    std::mutex _tls_mutex;
+    std::unordered_map<std::string, std::shared_ptr<TlsContext>> _client_tls_context;
+
+    // send rate limiter of each listen port
+    std::mutex _limiter_mutex;
+    std::unordered_map<uint16_t, std::shared_ptr<TokenBucket>> _listen_send_limiter;
+
+    // buffer memory of all connections and of each listen port
+    std::shared_ptr<MemoryCounter> _memory_counter;
+    std::mutex _memory_mutex;
+    std::unordered_map<uint16_t, std::shared_ptr<MemoryCounter>> _listen_memory_counter;
+
+    // frame decoder of each listen port
+    std::mutex _decoder_mutex;
+    std::unordered_map<uint16_t, std::shared_ptr<FrameDecoder>> _listen_frame_decoder;
 };
 
 } // namespace cppnet
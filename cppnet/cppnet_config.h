@@ -22,12 +22,37 @@ static const bool __epoll_exclusive        = !__reuse_port;
 
 // size of block memory in block memory pool.
 static const uint16_t __mem_block_size     = 1024;
+// number of block size classes in block memory pool, 1K 16K 256K.
+// buffer takes a large block when much data is expected.
+static const uint16_t __mem_block_class_num   = 3;
+// every size class is this times of the last one.
+static const uint16_t __mem_block_class_times = 16;
 // how many block memory will be add to block memory pool.
 static const uint16_t __mem_block_add_step = 5;
 // max number of blocks in memory pool. If block memory more than this number, will reduce to half.
-static const uint16_t __max_block_num      = 20;
+// the pool is shared by all connections of a dispatcher.
+// larger classes keep the same bytes, at least one block.
+static const uint16_t __max_block_num      = 256;
+// blocks not taken from the pool in this time are freed, so memory goes back
+// to system after traffic spikes. 0 means never, pool only releases half when full.
+static const uint32_t __mem_trim_interval_ms = 10000;
 // max data to write when net is busy.
 static const uint32_t __max_write_cache    = 1024 * 1024 * 4;
+// when reading is stopped by memory limit, check to read again after this time.
+static const uint16_t __memory_limit_recheck_ms = 100;
+// read buffer is one ring on shared memory mapped twice, data in it is always
+// continuous and parsers get one span. not supported on windows, block buffer is used.
+// every connection keeps its pages after they are touched, the pool is not used.
+static const bool __use_mirror_read_buffer      = false;
+// start size of mirror read buffer, rounded up to page size. doubled when full.
+static const uint32_t __mirror_read_buffer_size = 1024 * 16;
+// carve blocks and small objects of each dispatcher out of arenas backed by 2M huge pages,
+// fewer tlb misses with many connections. reserved huge pages(vm.nr_hugepages) are used first,
+// then transparent huge pages, then normal pages. arena memory is kept by the pool
+// and freed when dispatcher exits, the pool doesn't release half.
+static const bool __use_huge_page               = false;
+// size of each arena, rounded up to 2M.
+static const uint32_t __huge_page_arena_size    = 1024 * 1024 * 2;
 
 // log level. 
 static const uint16_t __log_level          = 15; // info level
@@ -35,6 +60,27 @@ static const uint16_t __log_level          = 15; // info level
 static const std::string __log_file_name   = "cppnet_log";
 // open log print.
 static const bool __print_log              = false;
+// every thread logs to its own ring of this size, a writer thread writes them to file.
+static const uint32_t __log_ring_size      = 1024 * 128;
+// the log writer thread prints logs to stdout too, as the stdout logger did before.
+static const bool __log_stdout             = true;
+// wait for room when ring is full, or drop the log and count it.
+static const bool __log_full_block         = false;
+// keep format string and arguments of logs, the log thread formats them.
+static const bool __log_defer_format       = false;
+// write logs to file without format, with less time and space. read it by log decoder.
+static const bool __log_binary_file        = false;
+// logs in hot paths print at most num logs in interval(ms) at a call site.
+static const uint32_t __log_hot_limit_num      = 10;
+static const uint32_t __log_hot_limit_interval = 1000;
+// logs printed every io loop print one of about rate logs.
+static const uint32_t __log_hot_sample_rate    = 100;
+// keep recent logs of this level in memory of every thread even if log print is off,
+// they are dumped to a file on SIGUSR1 or fatal log. 0 is off, 31 is debug level.
+static const uint16_t __log_record_level       = 0;
+// logs kept by every thread.
+static const uint32_t __log_record_slot_num    = 1024;
+static const std::string __log_record_file     = "cppnet_record";
 
 // EPOLL use et model.
 static const bool __epoll_use_et                   = true;
@@ -43,7 +89,7 @@ static const uint16_t __linux_read_buff_expand_len = 4096;
 // max extend size of read buff while buff isn't enough. 
 static const uint32_t __linux_read_buff_expand_max = 65536;
 // max size of buffer will get from buffer. Be careful IOV_MAX.
-static const uint16_t __linux_write_buff_get       = 4096;
+static const uint32_t __linux_write_buff_get       = 1024 * 64;
 // waiting time to re detect the connection status when connecting
 static const uint16_t __connect_recheck_time_ms    = 2000;
 
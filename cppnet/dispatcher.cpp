@@ -4,28 +4,51 @@
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
 #include <map>
+#include <cstdlib>
+#ifdef __linux__
+#include <malloc.h>
+#endif
 
 #include "cppnet/dispatcher.h"
 #include "cppnet/cppnet_base.h"
+#include "cppnet/cppnet_config.h"
 #include "cppnet/socket/rw_socket.h"
 #include "cppnet/event/timer_event.h"
 #include "cppnet/socket/connect_socket.h"
 #include "cppnet/event/action_interface.h"
 
+#include "common/log/log.h"
 #include "common/util/time.h"
 #include "common/timer/timer.h"
-#include "common/alloter/pool_alloter.h"
+#include "common/timer/timer_slot.h"
+#include "common/timer/high_res_timer.h"
+#include "common/alloter/pool_block.h"
+#include "common/alloter/slab_alloter.h"
+#include "common/alloter/huge_page_arena.h"
 
 namespace cppnet {
 
-thread_local std::unordered_map<uint64_t, std::shared_ptr<TimerEvent>> Dispatcher::__all_timer_event_map;
+thread_local PoolUnorderedMap<uint64_t, std::shared_ptr<TimerEvent>> Dispatcher::__all_timer_event_map;
 
 Dispatcher::Dispatcher(std::shared_ptr<CppNetBase> base, uint32_t thread_num, uint32_t base_id):
-    _cur_utc_time(0),
+    _cur_time(0),
+    _wakeups(0),
+    _wakeups_per_sec(0),
+    _wakeup_sec_start(0),
+    _wakeup_sec_num(0),
     _timer_id_creater(0),
+    _high_res_inited(false),
     _cppnet_base(base) {
 
-    _timer = MakeTimer1Min();
+    _timer = MakeTimerUnlimited();
+
+    std::shared_ptr<HugePageArena> arena;
+    if (__use_huge_page) {
+        arena = MakeHugePageArenaPtr(__huge_page_arena_size);
+    }
+    _slab_alloter = MakeSlabAlloterPtr(arena);
+    _alloter = std::make_shared<AlloterWrap>(_slab_alloter);
+    _block_pool = MakeBlockMemoryPoolPtr(__mem_block_size, __mem_block_add_step, __mem_block_class_num, arena);
 
     _event_actions = MakeEventActions();
     _event_actions->Init();
@@ -35,11 +58,24 @@ Dispatcher::Dispatcher(std::shared_ptr<CppNetBase> base, uint32_t thread_num, ui
 }
 
 Dispatcher::Dispatcher(std::shared_ptr<CppNetBase> base, uint32_t base_id):
-    _cur_utc_time(0),
+    _cur_time(0),
+    _wakeups(0),
+    _wakeups_per_sec(0),
+    _wakeup_sec_start(0),
+    _wakeup_sec_num(0),
     _timer_id_creater(0),
+    _high_res_inited(false),
     _cppnet_base(base) {
 
-    _timer = MakeTimer1Min();
+    _timer = MakeTimerUnlimited();
+
+    std::shared_ptr<HugePageArena> arena;
+    if (__use_huge_page) {
+        arena = MakeHugePageArenaPtr(__huge_page_arena_size);
+    }
+    _slab_alloter = MakeSlabAlloterPtr(arena);
+    _alloter = std::make_shared<AlloterWrap>(_slab_alloter);
+    _block_pool = MakeBlockMemoryPoolPtr(__mem_block_size, __mem_block_add_step, __mem_block_class_num, arena);
 
     _event_actions = MakeEventActions();
     _event_actions->Init();
@@ -57,14 +93,29 @@ Dispatcher::~Dispatcher() {
 
 void Dispatcher::Run() {
     _local_thread_id = std::this_thread::get_id();
-    _cur_utc_time = UTCTimeMsec();
+    _slab_alloter->SetOwnerThread();
+    SetThreadAlloter(_slab_alloter);
+    _cur_time = SteadyTimeMsec();
+    _wakeup_sec_start = _cur_time;
+    if (__mem_trim_interval_ms > 0) {
+        // trim is not in a hurry, run it with other timers
+        AddTimer([this](void*) { TrimMemory(); }, nullptr, __mem_trim_interval_ms, true, __mem_trim_interval_ms / 10);
+    }
     int32_t wait_time = 0;
     uint64_t cur_time = 0;
 
     while (!_stop) {
-        cur_time = UTCTimeMsec();
-        _timer->TimerRun(uint32_t(cur_time - _cur_utc_time));
-        _cur_utc_time = cur_time;
+        cur_time = SteadyTimeMsec();
+        _timer->TimerRun(uint32_t(cur_time - _cur_time));
+        _cur_time = cur_time;
+
+        uint64_t wakeups = _wakeups.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (cur_time - _wakeup_sec_start >= 1000) {
+            _wakeups_per_sec.store((uint32_t)((wakeups - _wakeup_sec_num) * 1000 / (cur_time - _wakeup_sec_start)),
+                std::memory_order_relaxed);
+            _wakeup_sec_start = cur_time;
+            _wakeup_sec_num = wakeups;
+        }
 
         if (_stop) {
             break;
@@ -75,7 +126,23 @@ void Dispatcher::Run() {
         _event_actions->ProcessEvent(wait_time);
 
         DoTask();
+
+        // objects freed by user threads
+        _slab_alloter->DrainRemoteFree();
     }
+    _slab_alloter->DrainRemoteFree();
+}
+
+void Dispatcher::TrimMemory() {
+    uint64_t bytes = _block_pool->Trim();
+    if (bytes == 0) {
+        return;
+    }
+#ifdef __GLIBC__
+    // freed blocks are in the heap of malloc, give pages back to system
+    malloc_trim(0);
+#endif
+    LOG_DEBUG("trim block memory pool. released:%llu", (unsigned long long)bytes);
 }
 
 void Dispatcher::Stop() {
@@ -83,13 +150,14 @@ void Dispatcher::Stop() {
     _event_actions->Wakeup();
 }
 
-void Dispatcher::Listen(uint64_t sock, const std::string& ip, uint16_t port) {
-    auto task = [sock, ip, port, this]() {
+void Dispatcher::Listen(uint64_t sock, const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context) {
+    auto task = [sock, ip, port, tls_context, this]() {
         auto connect_sock = MakeConnectSocket();
         connect_sock->SetEventActions(_event_actions);
         connect_sock->SetCppNetBase(_cppnet_base.lock());
         connect_sock->SetSocket(sock);
         connect_sock->SetDispatcher(shared_from_this());
+        connect_sock->SetTlsContext(tls_context);
 
         connect_sock->Bind(ip, port);
         connect_sock->Listen();
@@ -103,12 +171,18 @@ void Dispatcher::Listen(uint64_t sock, const std::string& ip, uint16_t port) {
     }
 }
 
-void Dispatcher::Connect(const std::string& ip, uint16_t port) {
-    auto task = [ip, port, this]() {
-        auto sock = MakeRWSocket();
+void Dispatcher::Connect(const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context) {
+    auto task = [ip, port, tls_context, this]() {
+        auto cppnet_base = _cppnet_base.lock();
+        if (!cppnet_base) {
+            return;
+        }
+        auto sock = MakeRWSocket(0, _alloter, _block_pool);
         sock->SetDispatcher(shared_from_this());
         sock->SetEventActions(_event_actions);
-        sock->SetCppNetBase(_cppnet_base.lock());
+        sock->SetCppNetBase(cppnet_base);
+        sock->SetTlsContext(tls_context);
+        sock->SetMemoryCounter(cppnet_base->GetMemoryCounter(), nullptr);
         sock->Connect(ip, port);
     };
 
@@ -128,7 +202,7 @@ void Dispatcher::PostTask(const Task& task) {
     _event_actions->Wakeup();
 }
 
-uint32_t Dispatcher::AddTimer(const user_timer_call_back& cb, void* param, uint32_t interval, bool always) {
+uint32_t Dispatcher::AddTimer(const user_timer_call_back& cb, void* param, uint32_t interval, bool always, uint32_t slack) {
     std::shared_ptr<TimerEvent> event = std::make_shared<TimerEvent>();
     event->AddType(ET_USER_TIMER);
     event->SetTimerCallBack(cb, param);
@@ -136,13 +210,13 @@ uint32_t Dispatcher::AddTimer(const user_timer_call_back& cb, void* param, uint3
     uint32_t timer_id = MakeTimerID();
 
     if (std::this_thread::get_id() == _local_thread_id) {
-        _timer->AddTimer(event, interval, always);
+        // the loop gets next wait time after call backs
+        _timer->AddTimer(event, interval, always, slack);
         __all_timer_event_map[timer_id] = event;
-        _event_actions->Wakeup();
         
     } else {
-        auto task = [event, timer_id, interval, always, this]() {
-            _timer->AddTimer(event, interval, always);
+        auto task = [event, timer_id, interval, always, slack, this]() {
+            _timer->AddTimer(event, interval, always, slack);
             __all_timer_event_map[timer_id] = event;
         };
         PostTask(task);
@@ -150,7 +224,7 @@ uint32_t Dispatcher::AddTimer(const user_timer_call_back& cb, void* param, uint3
     return timer_id;
 }
 
-uint32_t Dispatcher::AddTimer(std::shared_ptr<RWSocket> sock, uint32_t interval, bool always) {
+uint32_t Dispatcher::AddTimer(std::shared_ptr<RWSocket> sock, uint32_t interval, bool always, uint32_t slack) {
     std::shared_ptr<TimerEvent> event = std::make_shared<TimerEvent>();
     event->AddType(ET_TIMER);
     event->SetSocket(sock);
@@ -158,13 +232,13 @@ uint32_t Dispatcher::AddTimer(std::shared_ptr<RWSocket> sock, uint32_t interval,
     uint32_t timer_id = MakeTimerID();
 
     if (std::this_thread::get_id() == _local_thread_id) {
-        _timer->AddTimer(event, interval, always);
+        // the loop gets next wait time after call backs
+        _timer->AddTimer(event, interval, always, slack);
         __all_timer_event_map[timer_id] = event;
-        _event_actions->Wakeup();
         
     } else {
-        auto task = [event, timer_id, interval, always, this]() {
-            _timer->AddTimer(event, interval, always);
+        auto task = [event, timer_id, interval, always, slack, this]() {
+            _timer->AddTimer(event, interval, always, slack);
             __all_timer_event_map[timer_id] = event;
         };
         PostTask(task);
@@ -172,10 +246,28 @@ uint32_t Dispatcher::AddTimer(std::shared_ptr<RWSocket> sock, uint32_t interval,
     return timer_id;
 }
 
+uint32_t Dispatcher::AddHighResTimer(const user_timer_call_back& cb, void* param, uint64_t interval_us, bool always) {
+    uint32_t timer_id = MakeTimerID();
+
+    if (std::this_thread::get_id() == _local_thread_id) {
+        InnerAddHighResTimer(cb, param, interval_us, always, timer_id);
+
+    } else {
+        auto task = [cb, param, interval_us, always, timer_id, this]() {
+            InnerAddHighResTimer(cb, param, interval_us, always, timer_id);
+        };
+        PostTask(task);
+    }
+    return timer_id;
+}
+
 void Dispatcher::StopTimer(uint32_t timer_id) {
     if (std::this_thread::get_id() == _local_thread_id) {
         auto iter = __all_timer_event_map.find(timer_id);
         if (iter == __all_timer_event_map.end()) {
+            if (_high_res_timer) {
+                _high_res_timer->RmTimer(timer_id);
+            }
             return;
         }
         
@@ -186,6 +278,9 @@ void Dispatcher::StopTimer(uint32_t timer_id) {
         auto task = [timer_id, this]() {
             auto iter = __all_timer_event_map.find(timer_id);
             if (iter == __all_timer_event_map.end()) {
+                if (_high_res_timer) {
+                    _high_res_timer->RmTimer(timer_id);
+                }
                 return;
             }
 
@@ -196,6 +291,14 @@ void Dispatcher::StopTimer(uint32_t timer_id) {
     }
 }
 
+bool Dispatcher::AddTimer(std::shared_ptr<TimerSlot> t, uint32_t interval) {
+    return _timer->AddTimer(t, interval);
+}
+
+void Dispatcher::StopTimer(std::shared_ptr<TimerSlot> t) {
+    _timer->RmTimer(t);
+}
+
 void Dispatcher::DoTask() {
     std::vector<Task> func_vec;
     {
@@ -208,6 +311,36 @@ void Dispatcher::DoTask() {
     }
 }
 
+void Dispatcher::InnerAddHighResTimer(const user_timer_call_back& cb, void* param, uint64_t interval_us, bool always, uint32_t timer_id) {
+    if (!_high_res_inited) {
+        _high_res_inited = true;
+        auto timer = MakeHighResTimer();
+        if (timer->Init() && _event_actions->AddHighResTimer(timer)) {
+            _high_res_timer = timer;
+
+        } else {
+            LOG_WARN("high resolution timer is not supported, use timer wheel instead.");
+        }
+    }
+
+    if (_high_res_timer) {
+        _high_res_timer->AddTimer(timer_id, interval_us, cb, param, always);
+        return;
+    }
+
+    // round up to milliseconds
+    std::shared_ptr<TimerEvent> event = std::make_shared<TimerEvent>();
+    event->AddType(ET_USER_TIMER);
+    event->SetTimerCallBack(cb, param);
+    _timer->AddTimer(event, (uint32_t)((interval_us + 999) / 1000), always);
+    __all_timer_event_map[timer_id] = event;
+}
+
+void Dispatcher::GetWakeupStat(WakeupStat& stat) {
+    stat._wakeups = _wakeups.load(std::memory_order_relaxed);
+    stat._wakeups_per_sec = _wakeups_per_sec.load(std::memory_order_relaxed);
+}
+
 uint32_t Dispatcher::MakeTimerID() {
     std::unique_lock<std::mutex> lock(_timer_id_mutex);
     return ++_timer_id_creater;
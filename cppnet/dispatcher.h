@@ -7,6 +7,7 @@
 #define CPPNET_DISPATCHER
 
 #include <mutex>
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <functional>
@@ -14,6 +15,7 @@
 
 #include "include/cppnet_type.h"
 #include "common/thread/thread_with_queue.h"
+#include "common/alloter/alloter_interface.h"
 
 namespace cppnet {
 
@@ -21,9 +23,15 @@ using Task = std::function<void()>;
 
 class Timer;
 class RWSocket;
+class TimerSlot;
 class TimerEvent;
 class CppNetBase;
+class TlsContext;
+class AlloterWrap;
+class SlabAlloter;
 class EventActions;
+class HighResTimer;
+class BlockMemoryPool;
 
 class Dispatcher: 
     public Thread,
@@ -38,23 +46,48 @@ public:
 
     void Stop() override;
 
-    void Listen(uint64_t sock, const std::string& ip, uint16_t port);
+    void Listen(uint64_t sock, const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context = nullptr);
 
-    void Connect(const std::string& ip, uint16_t port);
+    void Connect(const std::string& ip, uint16_t port, std::shared_ptr<TlsContext> tls_context = nullptr);
 
     void PostTask(const Task& task);
 
-    uint32_t AddTimer(const user_timer_call_back& cb, void* param, uint32_t interval, bool always = false);
-    uint32_t AddTimer(std::shared_ptr<RWSocket> sock, uint32_t interval, bool always = false);
+    // slack: timer may be run up to slack milliseconds later, so
+    // near timers are run by one wake up.
+    uint32_t AddTimer(const user_timer_call_back& cb, void* param, uint32_t interval, bool always = false, uint32_t slack = 0);
+    uint32_t AddTimer(std::shared_ptr<RWSocket> sock, uint32_t interval, bool always = false, uint32_t slack = 0);
+    // interval in microseconds, driven by timerfd.
+    // falls back to timer wheel in milliseconds if timerfd is not supported.
+    uint32_t AddHighResTimer(const user_timer_call_back& cb, void* param, uint64_t interval_us, bool always = false);
     void StopTimer(uint32_t timer_id);
+    // timer owned by caller, only call in dispatcher thread.
+    bool AddTimer(std::shared_ptr<TimerSlot> t, uint32_t interval);
+    void StopTimer(std::shared_ptr<TimerSlot> t);
 
     std::thread::id GetThreadID() { return _local_thread_id; }
+    void GetWakeupStat(WakeupStat& stat);
+
+    // memory shared by all sockets of the dispatcher. small objects are
+    // taken without lock in dispatcher thread, see SlabAlloter.
+    // blocks are only used and released in dispatcher thread.
+    std::shared_ptr<AlloterWrap> GetAlloter() { return _alloter; }
+    std::shared_ptr<BlockMemoryPool> GetBlockMemoryPool() { return _block_pool; }
 
 private:
     void DoTask();
     uint32_t MakeTimerID();
+    // release memory not used since last trim
+    void TrimMemory();
+    void InnerAddHighResTimer(const user_timer_call_back& cb, void* param, uint64_t interval_us, bool always, uint32_t timer_id);
+
+    // monotonic time of last timer run
+    uint64_t _cur_time;
 
-    uint64_t _cur_utc_time;
+    // times the loop woke up, and count of the last second
+    std::atomic<uint64_t> _wakeups;
+    std::atomic<uint32_t> _wakeups_per_sec;
+    uint64_t _wakeup_sec_start;
+    uint64_t _wakeup_sec_num;
 
     std::mutex _timer_id_mutex;
     uint32_t _timer_id_creater;
@@ -64,11 +97,18 @@ private:
 
     std::thread::id _local_thread_id;
     std::shared_ptr<Timer> _timer;
+    // created when the first high resolution timer is added
+    bool _high_res_inited;
+    std::shared_ptr<HighResTimer> _high_res_timer;
     std::shared_ptr<EventActions> _event_actions;
 
+    std::shared_ptr<AlloterWrap>     _alloter;
+    std::shared_ptr<SlabAlloter>     _slab_alloter;
+    std::shared_ptr<BlockMemoryPool> _block_pool;
+
     std::weak_ptr<CppNetBase> _cppnet_base;
 
-    static thread_local std::unordered_map<uint64_t, std::shared_ptr<TimerEvent>> __all_timer_event_map;
+    static thread_local PoolUnorderedMap<uint64_t, std::shared_ptr<TimerEvent>> __all_timer_event_map;
 };
 
 }
@@ -19,6 +19,7 @@ class Timer;
 class Event;
 class Address;
 class TimeSolt;
+class HighResTimer;
 
 // net IO event interface
 class EventActions {
@@ -37,10 +38,15 @@ public:
     virtual bool AddDisconnection(Event* event) = 0;
 
     virtual bool DelEvent(Event* event) = 0;
+    // stop read event only, AddRecvEvent starts it again
+    virtual bool DelRecvEvent(Event* event) = 0;
     // IO thread process
     virtual void ProcessEvent(int32_t wait_ms) = 0;
     // weak up net IO thread
     virtual void Wakeup() = 0;
+    // run timers when fd of high resolution timer is readable.
+    // return false if not supported.
+    virtual bool AddHighResTimer(std::shared_ptr<HighResTimer> timer) = 0;
 };
 
 std::shared_ptr<EventActions> MakeEventActions();
@@ -30,6 +30,7 @@
 #include "common/os/convert.h"
 #include "common/network/socket.h"
 #include "common/network/io_handle.h"
+#include "common/timer/high_res_timer.h"
 #include "common/alloter/alloter_interface.h"
 
 namespace cppnet {
@@ -47,6 +48,7 @@ EpollEventActions::EpollEventActions():
     _active_list.resize(1024);
     memset(_pipe, 0, sizeof(_pipe));
     memset(&_pipe_content, 0, sizeof(_pipe_content));
+    memset(&_timer_content, 0, sizeof(_timer_content));
 }
 
 EpollEventActions::~EpollEventActions() {
@@ -272,6 +274,27 @@ bool EpollEventActions::DelEvent(Event* event) {
     return true;
 }
 
+bool EpollEventActions::DelRecvEvent(Event* event) {
+    if (!(event->GetType() & ET_READ)) {
+        return false;
+    }
+    event->RemoveType(ET_READ);
+
+    auto sock = event->GetSocket();
+    epoll_event* ep_event = (epoll_event*)event->GetData();
+    if (!sock || !ep_event || !(ep_event->events & EPOLLIN)) {
+        return false;
+    }
+
+    ep_event->events &= ~EPOLLIN;
+    int32_t ret = epoll_ctl(_epoll_handler, EPOLL_CTL_MOD, sock->GetSocket(), ep_event);
+    if (ret < 0) {
+        LOG_ERROR("remove read event from EPOLL failed! error :%d, socket : %d", errno, sock->GetSocket());
+        return false;
+    }
+    return true;
+}
+
 void EpollEventActions::ProcessEvent(int32_t wait_ms) {
     int16_t ret = epoll_wait(_epoll_handler, &*_active_list.begin(), (int)_active_list.size(), wait_ms);
     if (ret == -1) {
@@ -281,7 +304,7 @@ void EpollEventActions::ProcessEvent(int32_t wait_ms) {
         LOG_ERROR("EPOLL wait failed! error:%d, info:%s", errno, ErrnoInfo(errno));
 
     } else {
-        LOG_DEBUG("EPOLL get events! num:%d, TheadId: %ld", ret, std::this_thread::get_id());
+        LOG_DEBUG_SAMPLE(__log_hot_sample_rate, "EPOLL get events! num:%d, TheadId: %ld", ret, std::this_thread::get_id());
 
         OnEvent(_active_list, ret);
     }
@@ -297,13 +320,33 @@ void EpollEventActions::Wakeup() {
     }
 }
 
+bool EpollEventActions::AddHighResTimer(std::shared_ptr<HighResTimer> timer) {
+#ifdef __win__
+    return false;
+#else
+    if (_high_res_timer || timer->GetFd() < 0) {
+        return false;
+    }
+
+    _timer_content.events = EPOLLIN;
+    _timer_content.data.fd = timer->GetFd();
+    int32_t ret = epoll_ctl(_epoll_handler, EPOLL_CTL_ADD, timer->GetFd(), &_timer_content);
+    if (ret < 0) {
+        LOG_ERROR("add timerfd to EPOLL failed! error :%d", errno);
+        return false;
+    }
+    _high_res_timer = timer;
+    return true;
+#endif
+}
+
 void EpollEventActions::OnEvent(std::vector<epoll_event>& event_vec, int16_t num) {
     std::shared_ptr<Socket> sock;
     Event* event = nullptr;
 
     for (int i = 0; i < num; i++) {
         if ((uint32_t)event_vec[i].data.fd == _pipe[0]) {
-            LOG_WARN("weak up the IO thread, index : %d", i);
+            LOG_WARN_LIMIT(__log_hot_limit_num, __log_hot_limit_interval, "weak up the IO thread, index : %d", i);
             char buf[4];
 #ifdef __win__
             if (recv(_pipe[0], buf, 1, 0) <= 0) {
@@ -315,10 +358,15 @@ void EpollEventActions::OnEvent(std::vector<epoll_event>& event_vec, int16_t num
             continue;
         }
 
+        if (_high_res_timer && event_vec[i].data.fd == _high_res_timer->GetFd()) {
+            _high_res_timer->OnTimeout();
+            continue;
+        }
+
         event = (Event*)event_vec[i].data.ptr;
         sock = event->GetSocket();
         if (!sock) {
-            LOG_WARN("EPOLL weak up but socket already destroy, index : %d", i);
+            LOG_WARN_LIMIT(__log_hot_limit_num, __log_hot_limit_interval, "EPOLL weak up but socket already destroy, index : %d", i);
             continue;
         }
 
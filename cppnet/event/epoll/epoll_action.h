@@ -34,10 +34,12 @@ public:
     virtual bool AddDisconnection(Event* event);
 
     virtual bool DelEvent(Event* event);
+    virtual bool DelRecvEvent(Event* event);
     // io thread process
     virtual void ProcessEvent(int32_t wait_ms);
     // weak up net io thread
     virtual void Wakeup();
+    virtual bool AddHighResTimer(std::shared_ptr<HighResTimer> timer);
 
 private:
     void OnEvent(std::vector<epoll_event>& event_vec, int16_t num);
@@ -54,6 +56,8 @@ private:
     uint32_t    _pipe[2];
 #endif
     epoll_event _pipe_content;
+    epoll_event _timer_content;
+    std::shared_ptr<HighResTimer> _high_res_timer;
     std::vector<epoll_event> _active_list;
 
 };
@@ -34,6 +34,12 @@ const char* TypeString(EventType type) {
     case ET_INACTIONS:
         return "inactions";
         break;
+    case ET_SEND_LIMIT:
+        return "send_limit";
+        break;
+    case ET_MEMORY_LIMIT:
+        return "memory_limit";
+        break;
     default:
         return "unknow";
         break;
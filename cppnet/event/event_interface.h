@@ -21,6 +21,8 @@ enum EventType {
     ET_DISCONNECT       = 0x040,        // disconnect event
 
     ET_INACTIONS        = 0x080,        // set to actions
+    ET_SEND_LIMIT       = 0x100,        // send rate limit timer event
+    ET_MEMORY_LIMIT     = 0x200,        // memory limit timer event, check to read again
 };
 
 const char* TypeString(EventType type);
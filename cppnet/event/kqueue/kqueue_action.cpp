@@ -194,6 +194,24 @@ bool KqueueEventActions::DelEvent(Event* event) {
     return true;
 }
 
+bool KqueueEventActions::DelRecvEvent(Event* event) {
+    if (!(event->GetType() & ET_READ)) {
+        return false;
+    }
+    event->RemoveType(ET_READ);
+
+    auto sock = event->GetSocket();
+    if (!sock) {
+        return false;
+    }
+
+    // AddRecvEvent enables it again
+    struct kevent ev;
+    EV_SET(&ev, sock->GetSocket(), EVFILT_READ, EV_DISABLE, 0, 0, (void*)event);
+    _change_list.push_back(ev);
+    return true;
+}
+
 void KqueueEventActions::ProcessEvent(int32_t wait_ms) {
     int16_t ret = 0;
     if (wait_ms > 0) {
@@ -210,7 +228,7 @@ void KqueueEventActions::ProcessEvent(int32_t wait_ms) {
         LOG_ERROR("kevent faild! error:%d, info:%s", errno, ErrnoInfo(errno));
 
     } else {
-        LOG_DEBUG("kevent get events! num:%d, TheadId:%lld", ret, std::this_thread::get_id());
+        LOG_DEBUG_SAMPLE(__log_hot_sample_rate, "kevent get events! num:%d, TheadId:%lld", ret, std::this_thread::get_id());
 
         OnEvent(_active_list, ret);
     }
@@ -226,7 +244,7 @@ void KqueueEventActions::OnEvent(std::vector<struct kevent>& event_vec, int16_t
 
     for (int i = 0; i < num; i++) {
         if (event_vec[i].ident == _pipe[0]) {
-            LOG_INFO("weak up the io thread, index : %d", i);
+            LOG_INFO_LIMIT(__log_hot_limit_num, __log_hot_limit_interval, "weak up the io thread, index : %d", i);
             char buf[4];
             read(_pipe[0], buf, 1);
             continue;
@@ -239,7 +257,7 @@ void KqueueEventActions::OnEvent(std::vector<struct kevent>& event_vec, int16_t
         event = (Event*)event_vec[i].udata;
         sock = event->GetSocket();
         if (!sock) {
-            LOG_WARN("kqueue weak up but socket already destroy, index : %d", i);
+            LOG_WARN_LIMIT(__log_hot_limit_num, __log_hot_limit_interval, "kqueue weak up but socket already destroy, index : %d", i);
             continue;
         }
 
@@ -30,10 +30,13 @@ public:
     virtual bool AddDisconnection(Event* event);
 
     virtual bool DelEvent(Event* event);
+    virtual bool DelRecvEvent(Event* event);
     // io thread process
     virtual void ProcessEvent(int32_t wait_ms);
     // weak up net io thread
     virtual void Wakeup();
+    // timerfd is only on linux
+    virtual bool AddHighResTimer(std::shared_ptr<HighResTimer>) { return false; }
 
 private:
     void OnEvent(std::vector<struct kevent>& event_vec, int16_t num);
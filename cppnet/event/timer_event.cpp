@@ -15,6 +15,7 @@ void TimerEvent::SetTimerCallBack(const user_timer_call_back& cb, void* param) {
 }
 
 void TimerEvent::OnTimer() {
+    LOG_DEBUG("timer fires. type:%d", GetType());
     if (GetType() & ET_USER_TIMER) {
         _timer_cb(GetData());
 
@@ -23,6 +24,20 @@ void TimerEvent::OnTimer() {
         auto rw_sock = std::dynamic_pointer_cast<RWSocket>(sock);
         rw_sock->OnTimer();
 
+    } else if (GetType() & ET_SEND_LIMIT) {
+        auto sock = GetSocket();
+        auto rw_sock = std::dynamic_pointer_cast<RWSocket>(sock);
+        if (rw_sock) {
+            rw_sock->OnSendLimit();
+        }
+
+    } else if (GetType() & ET_MEMORY_LIMIT) {
+        auto sock = GetSocket();
+        auto rw_sock = std::dynamic_pointer_cast<RWSocket>(sock);
+        if (rw_sock) {
+            rw_sock->OnMemoryLimit();
+        }
+
     } else {
         LOG_ERROR("invalid timer type. type:%d", GetType());
     }
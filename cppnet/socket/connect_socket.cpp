@@ -14,6 +14,7 @@
 #include "common/network/io_handle.h"
 #include "common/alloter/pool_alloter.h"
 
+#include "cppnet/dispatcher.h"
 #include "cppnet/cppnet_base.h"
 #include "cppnet/cppnet_config.h"
 #include "cppnet/socket/rw_socket.h"
@@ -94,8 +95,12 @@ void ConnectSocket::Close() {
 }
 
 void ConnectSocket::OnAccept() {
+    auto dispatcher = GetDispatcher();
+    if (!dispatcher) {
+        return;
+    }
+
     while (true) {
-        std::shared_ptr<AlloterWrap> alloter = std::make_shared<AlloterWrap>(MakePoolAlloterPtr());
         Address address;
         //may get more than one connections
         auto ret = OsHandle::Accept(_sock, address);
@@ -103,7 +108,7 @@ void ConnectSocket::OnAccept() {
             if (ret._errno == EAGAIN || ret._errno == WSAEWOULDBLOCK) {
                 break;
             }
-            LOG_ERROR("accept socket filed! errno:%d, info:%s", ret._errno, ErrnoInfo(ret._errno));
+            LOG_ERROR_LIMIT(__log_hot_limit_num, __log_hot_limit_interval, "accept socket filed! errno:%d, info:%s", ret._errno, ErrnoInfo(ret._errno));
             break;
         }
 
@@ -116,21 +121,25 @@ void ConnectSocket::OnAccept() {
         SocketNoblocking(ret._return_value);
         
         //create a new socket.
-        auto sock = MakeRWSocket(ret._return_value, alloter);
+        // memory of all connections in the thread is shared
+        auto sock = MakeRWSocket(ret._return_value, dispatcher->GetAlloter(), dispatcher->GetBlockMemoryPool());
 
         sock->SetListenPort(_addr.GetAddrPort());
         sock->SetCppNetBase(cppnet_base);
         sock->SetEventActions(_event_actions);
         sock->SetAddress(std::move(address));
-        sock->SetDispatcher(GetDispatcher());
+        sock->SetDispatcher(dispatcher);
+
+        sock->SetTlsContext(_tls_context);
+        sock->SetListenSendLimiter(cppnet_base->GetListenSendLimiter(_addr.GetAddrPort()));
+        sock->SetFrameDecoder(cppnet_base->GetListenFrameDecoder(_addr.GetAddrPort()));
+        sock->SetMemoryCounter(cppnet_base->GetMemoryCounter(), cppnet_base->GetListenMemoryCounter(_addr.GetAddrPort()));
 
         __all_socket_map[ret._return_value] = sock;
+        LOG_DEBUG("accept a connection. socket:%d, port:%d", (int32_t)ret._return_value, (int32_t)_addr.GetAddrPort());
     
-        //call accept call back function
-        cppnet_base->OnAccept(sock);
-
-        //start read
-        sock->Read();
+        //call accept call back function and start read
+        sock->OnAccept();
     }
 }
 
@@ -12,6 +12,7 @@
 namespace cppnet {
 
 class Event;
+class TlsContext;
 class ConnectSocket:
     public Socket, 
     public std::enable_shared_from_this<ConnectSocket> { 
@@ -26,8 +27,13 @@ public:
     virtual void Close();
 
     virtual void OnAccept();
+
+    // accepted connections start tls handshake if set
+    void SetTlsContext(std::shared_ptr<TlsContext> ctx) { _tls_context = ctx; }
+
 private:
     Event*  _accept_event;
+    std::shared_ptr<TlsContext> _tls_context;
 };
 
 std::shared_ptr<ConnectSocket> MakeConnectSocket();
@@ -0,0 +1,157 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include "include/cppnet_buffer.h"
+#include "cppnet/socket/frame_decoder.h"
+
+namespace cppnet {
+
+// frame length is returned in int32_t
+static const uint32_t __max_frame_len = 0x7FFFFFFF;
+// max bytes of a varint of 64 bits
+static const uint8_t __max_varint_len = 10;
+
+LengthFrameDecoder::LengthFrameDecoder(uint8_t field_len, bool big_endian, bool include_header, uint32_t max_len):
+    _field_len(field_len),
+    _big_endian(big_endian),
+    _include_header(include_header),
+    _max_len(max_len) {
+
+    if (_field_len != 1 && _field_len != 2 && _field_len != 4 && _field_len != 8) {
+        _field_len = 0;
+    }
+    if (_max_len == 0 || _max_len > __max_frame_len - __max_varint_len) {
+        _max_len = __max_frame_len - __max_varint_len;
+    }
+}
+
+int32_t LengthFrameDecoder::Decode(const std::shared_ptr<Buffer>& buffer, uint32_t& header_len, uint32_t& trailer_len) {
+    char field[__max_varint_len];
+    uint32_t len = buffer->ReadNotMovePt(field, _field_len > 0 ? _field_len : __max_varint_len);
+
+    uint64_t value = 0;
+    if (_field_len > 0) {
+        if (len < _field_len) {
+            return 0;
+        }
+        DecodeFixed(field, value);
+        header_len = _field_len;
+
+    } else {
+        int32_t ret = DecodeVarint(field, len, value);
+        if (ret <= 0) {
+            return ret;
+        }
+        header_len = (uint32_t)ret;
+    }
+
+    if (_include_header) {
+        if (value < header_len) {
+            return -1;
+        }
+        value -= header_len;
+    }
+    if (value > _max_len) {
+        return -1;
+    }
+
+    trailer_len = 0;
+    uint32_t frame_len = header_len + (uint32_t)value;
+    if (buffer->GetCanReadLength() < frame_len) {
+        return 0;
+    }
+    return (int32_t)frame_len;
+}
+
+int32_t LengthFrameDecoder::DecodeVarint(const char* data, uint32_t len, uint64_t& value) {
+    value = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        uint8_t byte = (uint8_t)data[i];
+        value |= (uint64_t)(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            return (int32_t)i + 1;
+        }
+    }
+    // too long
+    if (len >= __max_varint_len) {
+        return -1;
+    }
+    return 0;
+}
+
+void LengthFrameDecoder::DecodeFixed(const char* data, uint64_t& value) {
+    value = 0;
+    for (uint8_t i = 0; i < _field_len; i++) {
+        uint8_t byte = (uint8_t)data[_big_endian ? i : _field_len - 1 - i];
+        value = (value << 8) | byte;
+    }
+}
+
+DelimiterFrameDecoder::DelimiterFrameDecoder(const std::string& delimiter, uint32_t max_len):
+    _delimiter(delimiter),
+    _max_len(max_len) {
+
+    if (_max_len == 0 || _max_len > __max_frame_len - _delimiter.length()) {
+        _max_len = __max_frame_len - (uint32_t)_delimiter.length();
+    }
+}
+
+int32_t DelimiterFrameDecoder::Decode(const std::shared_ptr<Buffer>& buffer, uint32_t& header_len, uint32_t& trailer_len) {
+    if (_delimiter.empty()) {
+        return -1;
+    }
+
+    uint32_t delimiter_len = (uint32_t)_delimiter.length();
+    // buffer remembers where the last search stopped
+    uint32_t frame_len = buffer->FindStr(_delimiter.c_str(), delimiter_len);
+    if (frame_len == 0) {
+        if (buffer->GetCanReadLength() > _max_len + delimiter_len) {
+            return -1;
+        }
+        return 0;
+    }
+
+    if (frame_len - delimiter_len > _max_len) {
+        return -1;
+    }
+    header_len = 0;
+    trailer_len = delimiter_len;
+    return (int32_t)frame_len;
+}
+
+FixedFrameDecoder::FixedFrameDecoder(uint32_t frame_len):
+    _frame_len(frame_len) {
+
+    if (_frame_len > __max_frame_len) {
+        _frame_len = __max_frame_len;
+    }
+}
+
+int32_t FixedFrameDecoder::Decode(const std::shared_ptr<Buffer>& buffer, uint32_t& header_len, uint32_t& trailer_len) {
+    if (_frame_len == 0) {
+        return -1;
+    }
+    if (buffer->GetCanReadLength() < _frame_len) {
+        return 0;
+    }
+    header_len = 0;
+    trailer_len = 0;
+    return (int32_t)_frame_len;
+}
+
+std::shared_ptr<FrameDecoder> MakeLengthFrameDecoder(uint8_t field_len, bool big_endian,
+    bool include_header, uint32_t max_len) {
+    return std::make_shared<LengthFrameDecoder>(field_len, big_endian, include_header, max_len);
+}
+
+std::shared_ptr<FrameDecoder> MakeDelimiterFrameDecoder(const std::string& delimiter, uint32_t max_len) {
+    return std::make_shared<DelimiterFrameDecoder>(delimiter, max_len);
+}
+
+std::shared_ptr<FrameDecoder> MakeFixedFrameDecoder(uint32_t frame_len) {
+    return std::make_shared<FixedFrameDecoder>(frame_len);
+}
+
+}
@@ -0,0 +1,63 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef CPPNET_SOCKET_FRAME_DECODER
+#define CPPNET_SOCKET_FRAME_DECODER
+
+#include "include/cppnet_frame.h"
+
+namespace cppnet {
+
+class LengthFrameDecoder:
+    public FrameDecoder {
+
+public:
+    LengthFrameDecoder(uint8_t field_len, bool big_endian, bool include_header, uint32_t max_len);
+    ~LengthFrameDecoder() {}
+
+    virtual int32_t Decode(const std::shared_ptr<Buffer>& buffer, uint32_t& header_len, uint32_t& trailer_len);
+
+private:
+    // return length of the field, 0 if not complete, -1 if invalid
+    int32_t DecodeVarint(const char* data, uint32_t len, uint64_t& value);
+    void DecodeFixed(const char* data, uint64_t& value);
+
+private:
+    uint8_t  _field_len;
+    bool     _big_endian;
+    bool     _include_header;
+    uint32_t _max_len;
+};
+
+class DelimiterFrameDecoder:
+    public FrameDecoder {
+
+public:
+    DelimiterFrameDecoder(const std::string& delimiter, uint32_t max_len);
+    ~DelimiterFrameDecoder() {}
+
+    virtual int32_t Decode(const std::shared_ptr<Buffer>& buffer, uint32_t& header_len, uint32_t& trailer_len);
+
+private:
+    std::string _delimiter;
+    uint32_t    _max_len;
+};
+
+class FixedFrameDecoder:
+    public FrameDecoder {
+
+public:
+    FixedFrameDecoder(uint32_t frame_len);
+    ~FixedFrameDecoder() {}
+
+    virtual int32_t Decode(const std::shared_ptr<Buffer>& buffer, uint32_t& header_len, uint32_t& trailer_len);
+
+private:
+    uint32_t _frame_len;
+};
+
+}
+
+#endif
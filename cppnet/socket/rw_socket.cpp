@@ -4,23 +4,35 @@
 // Author: caozhiyi (caozhiyi5@gmail.com)
 
 #include <errno.h>
+#include <algorithm>
 
 #include "cppnet/dispatcher.h"
 #include "cppnet/cppnet_base.h"
 #include "cppnet/cppnet_config.h"
 #include "cppnet/socket/rw_socket.h"
+#include "cppnet/socket/write_lanes.h"
+#include "cppnet/socket/frame_decoder.h"
+#include "cppnet/event/timer_event.h"
 #include "cppnet/event/event_interface.h"
 #include "cppnet/event/action_interface.h"
 
 #include "common/log/log.h"
+#include "common/util/time.h"
 #include "common/network/socket.h"
 #include "common/alloter/pool_block.h"
 #include "common/buffer/buffer_queue.h"
+#include "common/buffer/mirror_buffer.h"
 #include "common/alloter/pool_alloter.h"
+#include "common/util/token_bucket.h"
+#include "common/util/memory_counter.h"
+#ifdef __use_tls__
+#include "common/tls/tls_handle.h"
+#include "common/tls/tls_context.h"
+#endif
 
 namespace cppnet {
 
-thread_local std::unordered_map<uint64_t, std::shared_ptr<Socket>> RWSocket::__connecting_socket_map;
+thread_local PoolUnorderedMap<uint64_t, std::shared_ptr<Socket>> RWSocket::__connecting_socket_map;
 
 RWSocket::RWSocket():
     RWSocket(0, std::make_shared<AlloterWrap>(MakePoolAlloterPtr())) {
@@ -32,24 +44,53 @@ RWSocket::RWSocket(std::shared_ptr<AlloterWrap> alloter):
 }
 
 RWSocket::RWSocket(uint64_t sock, std::shared_ptr<AlloterWrap> alloter):
+    RWSocket(sock, alloter, nullptr) {
+
+}
+
+RWSocket::RWSocket(uint64_t sock, std::shared_ptr<AlloterWrap> alloter, std::shared_ptr<BlockMemoryPool> block_pool):
     Socket(sock),
     _context(nullptr),
     _timer_id(0),
     _listen_port(0),
     _shutdown(false),
+    _closing(false),
     _connecting(false),
+    _handshaking(false),
     _event(nullptr),
-    _alloter(alloter) {
+    _alloter(alloter),
+    _block_pool(block_pool),
+    _held_bytes(0) {
 
-    _block_pool = _alloter->PoolNewSharePtr<BlockMemoryPool>(__mem_block_size, __mem_block_add_step);
+    if (!_block_pool) {
+        _block_pool = _alloter->PoolNewSharePtr<BlockMemoryPool>(__mem_block_size, __mem_block_add_step, __mem_block_class_num);
+    }
 
-    _write_buffer = _alloter->PoolNewSharePtr<BufferQueue>(_block_pool, _alloter);
-    _read_buffer = _alloter->PoolNewSharePtr<BufferQueue>(_block_pool, _alloter);
+    _write_buffer = _alloter->PoolNewSharePtr<WriteLanes>(_block_pool, _alloter);
+    if (__use_mirror_read_buffer) {
+        _read_buffer = MakeMirrorBuffer(__mirror_read_buffer_size);
+    }
+    if (!_read_buffer) {
+        _read_buffer = _alloter->PoolNewSharePtr<BufferQueue>(_block_pool, _alloter);
+    }
 }
 
 RWSocket::~RWSocket() {
+    ReleaseMemory();
     _write_buffer.reset();
     _read_buffer.reset();
+    if (_send_limit_timer && _send_limit_timer->IsInTimer()) {
+        auto dispatcher = GetDispatcher();
+        if (dispatcher) {
+            dispatcher->StopTimer(_send_limit_timer);
+        }
+    }
+    if (_memory_limit_timer && _memory_limit_timer->IsInTimer()) {
+        auto dispatcher = GetDispatcher();
+        if (dispatcher) {
+            dispatcher->StopTimer(_memory_limit_timer);
+        }
+    }
     if (_alloter && _event) {
         _alloter->PoolDelete(_event);
     }
@@ -92,28 +133,90 @@ void RWSocket::Read() {
 }
 
 bool RWSocket::Write(const char* src, uint32_t len) {
+    return Write(src, len, CWP_NORMAL);
+}
+
+bool RWSocket::Write(const char* src, uint32_t len, uint16_t priority) {
+    if (!InDispatcherThread()) {
+        return PostWrite(std::make_shared<std::string>(src, len), priority);
+    }
+
     if (!_event) {
         _event = _alloter->PoolNew<Event>();
         _event->SetSocket(shared_from_this());
     }
 
     //can't send now
-    if (_write_buffer->GetCanReadLength() > 0) {
-        if (_write_buffer->GetCanReadLength() > __max_write_cache) {
-            return false;
-        }
-        
-        _write_buffer->Write(src, len);
-        auto actions = GetEventActions();
-        if (actions) {
-            return actions->AddSendEvent(_event);
+    bool cached = _write_buffer->GetCanReadLength() > 0 || _handshaking;
+    if (cached && _write_buffer->GetCanReadLength() > __max_write_cache) {
+        return false;
+    }
+    if (IsMemoryOver(CMP_REJECT_WRITE)) {
+        return false;
+    }
+
+    if (_write_buffer->Write(src, len, priority) < len) {
+        // no memory block, data is cut
+        LOG_ERROR("write to buffer out of memory. socket:%llu", (unsigned long long)_sock);
+        OnDisConnect(CEC_MEMORY_LIMIT);
+        return false;
+    }
+    if (!UpdateMemory()) {
+        return false;
+    }
+    return AfterWrite(cached);
+}
+
+bool RWSocket::Write(std::shared_ptr<Buffer> buffer, uint32_t len) {
+    return Write(buffer, len, CWP_NORMAL);
+}
+
+bool RWSocket::Write(std::shared_ptr<Buffer> buffer, uint32_t len, uint16_t priority) {
+    auto inner_buffer = std::dynamic_pointer_cast<InnerBuffer>(buffer);
+    if (!inner_buffer) {
+        return false;
+    }
+
+    // connection of another dispatcher, copy the data out in the thread
+    // of buffer and write it in the thread of this connection
+    if (!InDispatcherThread()) {
+        std::vector<BufferSpan> spans;
+        inner_buffer->GetReadableSpans(spans, len);
+        auto data = std::make_shared<std::string>();
+        for (auto& span : spans) {
+            data->append(span._data, span._len);
         }
+        inner_buffer->Consume((uint32_t)data->size());
+        return PostWrite(data, priority);
+    }
+
+    if (!_event) {
+        _event = _alloter->PoolNew<Event>();
+        _event->SetSocket(shared_from_this());
+    }
+
+    bool cached = _write_buffer->GetCanReadLength() > 0 || _handshaking;
+    if (cached && _write_buffer->GetCanReadLength() > __max_write_cache) {
+        return false;
+    }
+    if (IsMemoryOver(CMP_REJECT_WRITE)) {
         return false;
+    }
 
-    } else {
-        _write_buffer->Write(src, len);
-        return Send();
+    uint32_t can_read = inner_buffer->GetCanReadLength();
+    if (len == 0 || len > can_read) {
+        len = can_read;
     }
+    if (_write_buffer->Write(inner_buffer, len, priority) < len) {
+        // no memory block, data is cut
+        LOG_ERROR("write to buffer out of memory. socket:%llu", (unsigned long long)_sock);
+        OnDisConnect(CEC_MEMORY_LIMIT);
+        return false;
+    }
+    if (!UpdateMemory()) {
+        return false;
+    }
+    return AfterWrite(cached);
 }
 
 void RWSocket::Connect(const std::string& ip, uint16_t port) {
@@ -148,25 +251,32 @@ void RWSocket::Connect(const std::string& ip, uint16_t port) {
 }
 
 void RWSocket::Disconnect() {
+    _closing = true;
     if (!_event) {
         _event = _alloter->PoolNew<Event>();
         _event->SetSocket(shared_from_this());
     }
 
+#ifdef __use_tls__
+    if (_tls) {
+        _tls->Shutdown();
+    }
+#endif
+
     auto actions = GetEventActions();
     if (actions) {
         actions->AddDisconnection(_event);
     }
 }
 
-void RWSocket::AddTimer(uint32_t interval, bool always) {
+void RWSocket::AddTimer(uint32_t interval, bool always, uint32_t slack) {
     if (_timer_id > 0) {
         return;
     }
     
     auto dispatcher = GetDispatcher();
     if (dispatcher) {
-        _timer_id = dispatcher->AddTimer(shared_from_this(), interval, always);
+        _timer_id = dispatcher->AddTimer(shared_from_this(), interval, always, slack);
     }
 }
 
@@ -182,6 +292,51 @@ void RWSocket::StopTimer() {
     }
 }
 
+void RWSocket::SetSendRate(uint32_t rate, uint32_t burst) {
+    if (rate == 0) {
+        _send_limiter.reset();
+        return;
+    }
+
+    if (_send_limiter) {
+        _send_limiter->SetRate(rate, burst);
+
+    } else {
+        _send_limiter = std::make_shared<TokenBucket>(rate, burst);
+    }
+}
+
+void RWSocket::OnSendLimit() {
+    if (IsShutdown() || _handshaking) {
+        return;
+    }
+    Send();
+}
+
+void RWSocket::SetMemoryCounter(std::shared_ptr<MemoryCounter> counter, std::shared_ptr<MemoryCounter> listen_counter) {
+    ReleaseMemory();
+    _memory_counter = counter;
+    _listen_memory_counter = listen_counter;
+    if (_memory_counter) {
+        _memory_counter->AddConnection();
+    }
+    if (_listen_memory_counter) {
+        _listen_memory_counter->AddConnection();
+    }
+}
+
+void RWSocket::OnMemoryLimit() {
+    if (IsShutdown()) {
+        return;
+    }
+    if (IsMemoryOver(CMP_STOP_READ, false)) {
+        StopRead();
+        return;
+    }
+    // data arrived while stopped is notified again
+    Read();
+}
+
 void RWSocket::OnTimer() {
     if (_connecting) {
         __connecting_socket_map.erase(_sock);
@@ -199,11 +354,39 @@ void RWSocket::OnTimer() {
     cppnet_base->OnTimer(shared_from_this());
 }
 
+void RWSocket::OnAccept() {
+    if (_tls_context) {
+        if (!StartTls()) {
+            __all_socket_map.erase(_sock);
+            OsHandle::Close(_sock);
+            return;
+        }
+        // accept call back is invoked after handshake
+        Read();
+        Handshake();
+        return;
+    }
+
+    auto cppnet_base = _cppnet_base.lock();
+    if (cppnet_base) {
+        cppnet_base->OnAccept(shared_from_this());
+    }
+    Read();
+}
+
 void RWSocket::OnRead(uint32_t len) {
+    if (_handshaking) {
+        Handshake();
+        return;
+    }
     Recv(len);
 }
 
 void RWSocket::OnWrite(uint32_t len) {
+    if (_handshaking) {
+        Handshake();
+        return;
+    }
     Send();
 }
 
@@ -211,6 +394,17 @@ void RWSocket::OnConnect(uint16_t err) {
     __connecting_socket_map.erase(_sock);
     _connecting = false;
     auto sock = shared_from_this();
+    if (err == CEC_SUCCESS && _tls_context) {
+        if (StartTls()) {
+            // connect call back is invoked after handshake
+            __all_socket_map[_sock] = sock;
+            Read();
+            Handshake();
+            return;
+        }
+        err = CEC_CONNECT_REFUSE;
+    }
+
     if (err == CEC_SUCCESS) {
         __all_socket_map[_sock] = sock;
     }
@@ -226,16 +420,19 @@ void RWSocket::OnConnect(uint16_t err) {
 }
 
 void RWSocket::OnDisConnect(uint16_t err) {
+    LOG_DEBUG("connection closed. socket:%llu, err:%d", (unsigned long long)_sock, err);
     auto sock = shared_from_this();
     __all_socket_map.erase(_sock);
 
-    if (!IsShutdown()) {
+    // user never knows the connection before handshake is done
+    if (!IsShutdown() && !_handshaking) {
         auto cppnet_base = _cppnet_base.lock();
         if (cppnet_base) {
             cppnet_base->OnDisConnect(sock, err);
         }
     }
     SetShutdown();
+    ReleaseMemory();
 
     // peer disconnect or connection break.
     if (_event && err != CEC_SUCCESS) {
@@ -252,6 +449,11 @@ bool RWSocket::Recv(uint32_t len) {
     if (!cppnet_base) {
         return false;
     }
+    // data is left in socket, peer waits
+    if (IsMemoryOver(CMP_STOP_READ)) {
+        StopRead();
+        return true;
+    }
     if (len == 0) {
         len = __linux_read_buff_expand_len;
     }
@@ -271,14 +473,24 @@ bool RWSocket::Recv(uint32_t len) {
 
         std::vector<Iovec> io_vec;
         uint32_t buff_len = _read_buffer->GetFreeMemoryBlock(io_vec, expand);
-        auto ret = OsHandle::Readv(_sock, &*io_vec.begin(), io_vec.size());
+        if (buff_len == 0 || io_vec.empty()) {
+            LOG_ERROR("read buffer out of memory. socket:%llu", (unsigned long long)_sock);
+            OnDisConnect(CEC_MEMORY_LIMIT);
+            return false;
+        }
+#ifdef __use_tls__
+        auto ret = _tls ? _tls->Readv(_sock, &*io_vec.begin(), (uint32_t)io_vec.size()) :
+            OsHandle::Readv(_sock, &*io_vec.begin(), (uint32_t)io_vec.size());
+#else
+        auto ret = OsHandle::Readv(_sock, &*io_vec.begin(), (uint32_t)io_vec.size());
+#endif
         if (ret._return_value < 0 || ret._errno > 0) {
             if (errno == EWOULDBLOCK || errno == EAGAIN || errno == EINTR) {
-                _read_buffer->MoveWritePt(ret._return_value);
-                off_set += ret._return_value;
                 break;
 
             } else {
+                LOG_WARN_LIMIT(__log_hot_limit_num, __log_hot_limit_interval, "recv from socket failed. socket:%llu, errno:%d",
+                    (unsigned long long)_sock, errno);
                 OnDisConnect(CEC_CONNECT_BREAK);
                 return false;
             }
@@ -292,12 +504,63 @@ bool RWSocket::Recv(uint32_t len) {
             off_set += ret._return_value;
             // read all
             if ((uint32_t)ret._return_value < buff_len) {
+                // openssl returns at record boundary, read until EAGAIN
+                if (_tls) {
+                    continue;
+                }
                 break;
             }
             need_expend = true;
         }
     }
-    cppnet_base->OnRead(shared_from_this(), _read_buffer, off_set);
+    if (off_set > 0) {
+        if (_frame_decoder) {
+            if (!DecodeFrames(cppnet_base)) {
+                return false;
+            }
+
+        } else {
+            cppnet_base->OnRead(shared_from_this(), _read_buffer, off_set);
+        }
+        // idle connection keeps no block
+        _read_buffer->Shrink();
+        return UpdateMemory();
+    }
+    return true;
+}
+
+bool RWSocket::DecodeFrames(std::shared_ptr<CppNetBase>& cppnet_base) {
+    std::shared_ptr<Buffer> buffer = _read_buffer;
+    std::vector<BufferSpan> spans;
+    // stop if the frame call back closes the connection
+    while (!IsShutdown() && !_closing && _read_buffer->GetCanReadLength() > 0) {
+        uint32_t header_len = 0;
+        uint32_t trailer_len = 0;
+        int32_t frame_len = _frame_decoder->Decode(buffer, header_len, trailer_len);
+        if (frame_len == 0) {
+            break;
+        }
+        if (frame_len < 0 || (uint32_t)frame_len < header_len + trailer_len) {
+            LOG_WARN("invalid frame data. socket:%llu", (unsigned long long)_sock);
+            OnDisConnect(CEC_FRAME_ERROR);
+            return false;
+        }
+
+        // frame in one block is called back without copy
+        const char* frame = nullptr;
+        spans.clear();
+        _read_buffer->GetReadableSpans(spans, frame_len);
+        if (spans.size() == 1 && spans[0]._len >= (uint32_t)frame_len) {
+            frame = spans[0]._data;
+
+        } else {
+            _frame_cache.resize(frame_len);
+            _read_buffer->ReadNotMovePt(&_frame_cache[0], frame_len);
+            frame = _frame_cache.data();
+        }
+        cppnet_base->OnFrame(shared_from_this(), frame + header_len, frame_len - header_len - trailer_len);
+        _read_buffer->Consume(frame_len);
+    }
     return true;
 }
 
@@ -308,13 +571,40 @@ bool RWSocket::Send() {
     }
 
     uint32_t off_set = 0;
+    bool limited = _send_limiter || _listen_send_limiter;
     while(_write_buffer && _write_buffer->GetCanReadLength() > 0) {
+        uint32_t max_size = __linux_write_buff_get;
+        if (limited) {
+            uint32_t quota = SendQuota();
+            // left data will be sent by send limit timer
+            if (quota == 0) {
+                break;
+            }
+            if (quota < max_size) {
+                max_size = quota;
+            }
+        }
+
         std::vector<Iovec> io_vec;
-        _write_buffer->GetUseMemoryBlock(io_vec, __linux_write_buff_get);
-        auto ret = OsHandle::Writev(_sock, &*io_vec.begin(), io_vec.size());
+        _write_buffer->GetUseMemoryBlock(io_vec, max_size);
+#ifdef __use_tls__
+        auto ret = _tls ? _tls->Writev(_sock, &*io_vec.begin(), (uint32_t)io_vec.size()) :
+            OsHandle::Writev(_sock, &*io_vec.begin(), (uint32_t)io_vec.size());
+#else
+        auto ret = OsHandle::Writev(_sock, &*io_vec.begin(), (uint32_t)io_vec.size());
+#endif
         if (ret._return_value >= 0 && ret._errno == 0) {
             _write_buffer->MoveReadPt(ret._return_value);
+            UpdateMemory();
             off_set += ret._return_value;
+            if (limited) {
+                if (_send_limiter) {
+                    _send_limiter->Consume(ret._return_value);
+                }
+                if (_listen_send_limiter) {
+                    _listen_send_limiter->Consume(ret._return_value);
+                }
+            }
 
         } else {
             if (errno == EWOULDBLOCK || errno == EAGAIN || errno == EINTR) {
@@ -335,10 +625,233 @@ bool RWSocket::Send() {
             }
         }
     }
-    cppnet_base->OnWrite(shared_from_this(), off_set);
+    _write_buffer->Shrink();
+    if (off_set > 0) {
+        cppnet_base->OnWrite(shared_from_this(), off_set);
+    }
+    return true;
+}
+
+bool RWSocket::AfterWrite(bool cached) {
+    if (!cached) {
+        return Send();
+    }
+
+    // cached data will be sent after handshake or when tokens are enough
+    if (_handshaking || IsSendLimitWaiting()) {
+        return true;
+    }
+
+    // send event is waiting already, data will be sent with it
+    if (_event->GetType() & ET_WRITE) {
+        return true;
+    }
+
+    auto actions = GetEventActions();
+    if (actions) {
+        return actions->AddSendEvent(_event);
+    }
+    return false;
+}
+
+bool RWSocket::InDispatcherThread() {
+    auto dispatcher = GetDispatcher();
+    return !dispatcher || dispatcher->GetThreadID() == std::this_thread::get_id();
+}
+
+bool RWSocket::PostWrite(std::shared_ptr<std::string> data, uint16_t priority) {
+    auto dispatcher = GetDispatcher();
+    if (!dispatcher || IsShutdown()) {
+        return false;
+    }
+    auto sock = shared_from_this();
+    dispatcher->PostTask([sock, data, priority]() {
+        if (!sock->IsShutdown()) {
+            sock->Write(data->data(), (uint32_t)data->size(), priority);
+        }
+    });
+    return true;
+}
+
+bool RWSocket::StartTls() {
+#ifdef __use_tls__
+    _tls = _tls_context->NewHandle(_sock);
+    _handshaking = (_tls != nullptr);
+    return _handshaking;
+#else
+    return false;
+#endif
+}
+
+void RWSocket::Handshake() {
+#ifdef __use_tls__
+    auto status = _tls->Handshake();
+    if (status == TS_WANT_READ) {
+        return;
+    }
+
+    if (status == TS_WANT_WRITE) {
+        auto actions = GetEventActions();
+        if (actions) {
+            actions->AddSendEvent(_event);
+        }
+        return;
+    }
+
+    auto sock = shared_from_this();
+    auto cppnet_base = _cppnet_base.lock();
+    if (status == TS_ERROR) {
+        if (cppnet_base && !_tls->IsServer()) {
+            cppnet_base->OnConnect(sock, CEC_CONNECT_REFUSE);
+        }
+        OnDisConnect(CEC_CONNECT_BREAK);
+        return;
+    }
+
+    _handshaking = false;
+    if (cppnet_base) {
+        if (_tls->IsServer()) {
+            cppnet_base->OnAccept(sock);
+
+        } else {
+            cppnet_base->OnConnect(sock, CEC_SUCCESS);
+        }
+    }
+
+    // send data cached while handshaking
+    if (_write_buffer->GetCanReadLength() > 0) {
+        Send();
+    }
+    // peer's data may arrive with the last handshake message
+    Recv(0);
+#endif
+}
+
+uint32_t RWSocket::SendQuota() {
+    uint64_t now = SteadyTimeMsec();
+    uint32_t quota = UINT32_MAX;
+    if (_send_limiter) {
+        quota = std::min(quota, _send_limiter->Available(now));
+    }
+    if (_listen_send_limiter) {
+        quota = std::min(quota, _listen_send_limiter->Available(now));
+    }
+    if (quota > 0) {
+        return quota;
+    }
+
+    // wait until a whole write can be done, don't wake up for every few bytes
+    uint32_t want = std::min(_write_buffer->GetCanReadLength(), (uint32_t)__linux_write_buff_get);
+    uint32_t wait = 0;
+    if (_send_limiter) {
+        wait = std::max(wait, _send_limiter->WaitTime(want, now));
+    }
+    if (_listen_send_limiter) {
+        wait = std::max(wait, _listen_send_limiter->WaitTime(want, now));
+    }
+    if (wait == 0) {
+        wait = 1;
+    }
+
+    if (!_send_limit_timer) {
+        _send_limit_timer = std::make_shared<TimerEvent>();
+        _send_limit_timer->AddType(ET_SEND_LIMIT);
+        _send_limit_timer->SetSocket(shared_from_this());
+    }
+    if (!_send_limit_timer->IsInTimer()) {
+        auto dispatcher = GetDispatcher();
+        if (dispatcher) {
+            dispatcher->AddTimer(_send_limit_timer, wait);
+        }
+    }
+    return 0;
+}
+
+bool RWSocket::IsSendLimitWaiting() {
+    return _send_limit_timer && _send_limit_timer->IsInTimer();
+}
+
+bool RWSocket::UpdateMemory() {
+    if (!_memory_counter && !_listen_memory_counter) {
+        return true;
+    }
+
+    uint64_t held = (uint64_t)_read_buffer->GetCanReadLength() + _write_buffer->GetCanReadLength();
+    if (held == _held_bytes) {
+        return true;
+    }
+    int64_t change = (int64_t)held - (int64_t)_held_bytes;
+    _held_bytes = held;
+    if (_memory_counter) {
+        _memory_counter->Add(change);
+    }
+    if (_listen_memory_counter) {
+        _listen_memory_counter->Add(change);
+    }
+
+    // only a growing connection is closed
+    if (change < 0 || IsShutdown()) {
+        return true;
+    }
+    std::shared_ptr<MemoryCounter> counters[] = { _memory_counter, _listen_memory_counter };
+    for (auto& counter : counters) {
+        if (counter && counter->IsOverLimit(CMP_CLOSE_LARGEST) && _held_bytes >= counter->GetAverage()) {
+            counter->AddShed(CMP_CLOSE_LARGEST);
+            LOG_WARN("close connection by memory limit. socket:%llu, held:%llu, used:%llu",
+                (unsigned long long)_sock, (unsigned long long)_held_bytes, (unsigned long long)counter->GetUsed());
+            OnDisConnect(CEC_MEMORY_LIMIT);
+            return false;
+        }
+    }
     return true;
 }
 
+void RWSocket::ReleaseMemory() {
+    if (_memory_counter) {
+        _memory_counter->Add(-(int64_t)_held_bytes);
+        _memory_counter->RemoveConnection();
+        _memory_counter.reset();
+    }
+    if (_listen_memory_counter) {
+        _listen_memory_counter->Add(-(int64_t)_held_bytes);
+        _listen_memory_counter->RemoveConnection();
+        _listen_memory_counter.reset();
+    }
+    _held_bytes = 0;
+}
+
+bool RWSocket::IsMemoryOver(uint16_t policy, bool count) {
+    std::shared_ptr<MemoryCounter> counters[] = { _memory_counter, _listen_memory_counter };
+    for (auto& counter : counters) {
+        if (counter && counter->IsOverLimit(policy)) {
+            if (count) {
+                counter->AddShed(policy);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void RWSocket::StopRead() {
+    auto actions = GetEventActions();
+    if (actions && _event) {
+        actions->DelRecvEvent(_event);
+    }
+
+    if (!_memory_limit_timer) {
+        _memory_limit_timer = std::make_shared<TimerEvent>();
+        _memory_limit_timer->AddType(ET_MEMORY_LIMIT);
+        _memory_limit_timer->SetSocket(shared_from_this());
+    }
+    if (!_memory_limit_timer->IsInTimer()) {
+        auto dispatcher = GetDispatcher();
+        if (dispatcher) {
+            dispatcher->AddTimer(_memory_limit_timer, __memory_limit_recheck_ms);
+        }
+    }
+}
+
 std::shared_ptr<RWSocket> MakeRWSocket() {
     return std::make_shared<RWSocket>();
 }
@@ -351,5 +864,18 @@ std::shared_ptr<RWSocket> MakeRWSocket(uint64_t sock, std::shared_ptr<AlloterWra
     return std::make_shared<RWSocket>(sock, alloter);
 }
 
+std::shared_ptr<RWSocket> MakeRWSocket(uint64_t sock, std::shared_ptr<AlloterWrap> alloter,
+    std::shared_ptr<BlockMemoryPool> block_pool) {
+    // user may release the last handle in other thread
+    return std::shared_ptr<RWSocket>(new RWSocket(sock, alloter, block_pool), [](RWSocket* rw_sock) {
+        auto dispatcher = rw_sock->GetDispatcher();
+        if (dispatcher && std::this_thread::get_id() != dispatcher->GetThreadID()) {
+            dispatcher->PostTask([rw_sock]() { delete rw_sock; });
+            return;
+        }
+        delete rw_sock;
+    });
+}
+
 
 }
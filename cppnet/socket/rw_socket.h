@@ -14,8 +14,15 @@
 namespace cppnet {
 
 class Event;
-class BufferQueue;
+class TlsHandle;
+class TimerEvent;
+class TokenBucket;
+class TlsContext;
+class WriteLanes;
+class InnerBuffer;
 class AlloterWrap;
+class FrameDecoder;
+class MemoryCounter;
 class BlockMemoryPool;
 
 class RWSocket:
@@ -28,6 +35,8 @@ public:
     RWSocket();
     RWSocket(std::shared_ptr<AlloterWrap> alloter);
     RWSocket(uint64_t sock, std::shared_ptr<AlloterWrap> alloter);
+    // alloter and block pool are shared with other sockets of the dispatcher
+    RWSocket(uint64_t sock, std::shared_ptr<AlloterWrap> alloter, std::shared_ptr<BlockMemoryPool> block_pool);
     virtual ~RWSocket();
 
     virtual uint64_t GetSocket() { return _sock; }
@@ -39,13 +48,17 @@ public:
 
     virtual void Read();
     virtual bool Write(const char* src, uint32_t len);
+    virtual bool Write(const char* src, uint32_t len, uint16_t priority);
+    virtual bool Write(std::shared_ptr<Buffer> buffer, uint32_t len = 0);
+    virtual bool Write(std::shared_ptr<Buffer> buffer, uint32_t len, uint16_t priority);
     virtual void Connect(const std::string& ip, uint16_t port);
     virtual void Disconnect();
 
-    virtual void AddTimer(uint32_t interval, bool always = false);
+    virtual void AddTimer(uint32_t interval, bool always = false, uint32_t slack = 0);
     virtual void StopTimer();
 
     virtual void OnTimer();
+    virtual void OnAccept();
     virtual void OnRead(uint32_t len = 0);
     virtual void OnWrite(uint32_t len = 0);
     virtual void OnConnect(uint16_t err);
@@ -57,32 +70,98 @@ public:
     virtual void SetShutdown() { _shutdown = true; }
     virtual bool IsShutdown() { return _shutdown; }
 
+    virtual void SetSendRate(uint32_t rate, uint32_t burst = 0);
+    // bucket shared by all connections of the listener
+    void SetListenSendLimiter(std::shared_ptr<TokenBucket> limiter) { _listen_send_limiter = limiter; }
+    // send rate limit timer out, continue to send
+    void OnSendLimit();
+
+    // count bytes of buffers to all connections and to the listen port.
+    // listen_counter is nullptr for client connections.
+    void SetMemoryCounter(std::shared_ptr<MemoryCounter> counter, std::shared_ptr<MemoryCounter> listen_counter);
+    // reading stopped by memory limit, check to read again
+    void OnMemoryLimit();
+
+    // frames are cut before call back if set
+    void SetFrameDecoder(std::shared_ptr<FrameDecoder> decoder) { _frame_decoder = decoder; }
+
     std::shared_ptr<AlloterWrap> GetAlloter() { return _alloter; }
 
+    // connection call back is invoked after tls handshake if set
+    void SetTlsContext(std::shared_ptr<TlsContext> ctx) { _tls_context = ctx; }
+
 private:
     bool Recv(uint32_t len);
     bool Send();
+    // data is written to the cache, send it or wait.
+    // cached: there was data waiting already.
+    bool AfterWrite(bool cached);
+    // memory of the dispatcher is used without lock, a write
+    // from another thread is done in the dispatcher thread.
+    bool InDispatcherThread();
+    bool PostWrite(std::shared_ptr<std::string> data, uint16_t priority);
+
+    bool StartTls();
+    void Handshake();
+
+    // bytes allowed to send now. if 0, a timer is set to wait for tokens.
+    uint32_t SendQuota();
+    bool IsSendLimitWaiting();
+
+    // sync bytes held by buffers to memory counters.
+    // return false if the connection is closed by memory limit.
+    bool UpdateMemory();
+    void ReleaseMemory();
+    // count: count it to the stat if over limit
+    bool IsMemoryOver(uint16_t policy, bool count = true);
+    void StopRead();
+
+    // call back every complete frame in read buffer.
+    // return false if the connection is closed by invalid data.
+    bool DecodeFrames(std::shared_ptr<CppNetBase>& cppnet_base);
 
 protected:
     void*    _context;
     uint32_t _timer_id;
     uint16_t _listen_port;
     std::atomic_bool _shutdown;
+    // close is required, the disconnection is queued
+    std::atomic_bool _closing;
     std::atomic_bool _connecting;
+    bool             _handshaking;
     Event*           _event;
 
-    std::shared_ptr<BufferQueue>     _write_buffer;
-    std::shared_ptr<BufferQueue>     _read_buffer;
+    std::shared_ptr<WriteLanes>      _write_buffer;
+    std::shared_ptr<InnerBuffer>     _read_buffer;
 
     std::shared_ptr<AlloterWrap>     _alloter;
     std::shared_ptr<BlockMemoryPool> _block_pool;
 
-    static thread_local std::unordered_map<uint64_t, std::shared_ptr<Socket>> __connecting_socket_map;
+    std::shared_ptr<TlsHandle>       _tls;
+    std::shared_ptr<TlsContext>      _tls_context;
+
+    std::shared_ptr<TokenBucket>     _send_limiter;
+    std::shared_ptr<TokenBucket>     _listen_send_limiter;
+    std::shared_ptr<TimerEvent>      _send_limit_timer;
+
+    uint64_t                         _held_bytes;
+    std::shared_ptr<MemoryCounter>   _memory_counter;
+    std::shared_ptr<MemoryCounter>   _listen_memory_counter;
+    std::shared_ptr<TimerEvent>      _memory_limit_timer;
+
+    std::shared_ptr<FrameDecoder>    _frame_decoder;
+    // a frame across memory blocks is copied here
+    std::string                      _frame_cache;
+
+    static thread_local PoolUnorderedMap<uint64_t, std::shared_ptr<Socket>> __connecting_socket_map;
 };
 
 std::shared_ptr<RWSocket> MakeRWSocket();
 std::shared_ptr<RWSocket> MakeRWSocket(std::shared_ptr<AlloterWrap> alloter);
 std::shared_ptr<RWSocket> MakeRWSocket(uint64_t sock, std::shared_ptr<AlloterWrap> alloter);
+// the socket is released in dispatcher thread, the memory is not locked.
+std::shared_ptr<RWSocket> MakeRWSocket(uint64_t sock, std::shared_ptr<AlloterWrap> alloter,
+    std::shared_ptr<BlockMemoryPool> block_pool);
 
 }
 
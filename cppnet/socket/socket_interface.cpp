@@ -7,6 +7,6 @@
 
 namespace cppnet {
 
-thread_local std::unordered_map<uint64_t, std::shared_ptr<Socket>> Socket::__all_socket_map;
+thread_local PoolUnorderedMap<uint64_t, std::shared_ptr<Socket>> Socket::__all_socket_map;
 
 }
\ No newline at end of file
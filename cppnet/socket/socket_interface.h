@@ -11,6 +11,7 @@
 #include <unordered_map>
 
 #include "common/network/address.h"
+#include "common/alloter/alloter_interface.h"
 
 namespace cppnet {
 
@@ -47,7 +48,7 @@ protected:
     std::weak_ptr<EventActions> _event_actions;
     std::weak_ptr<Dispatcher>   _dispatcher;
 
-    static thread_local std::unordered_map<uint64_t, std::shared_ptr<Socket>> __all_socket_map;
+    static thread_local PoolUnorderedMap<uint64_t, std::shared_ptr<Socket>> __all_socket_map;
 };
 
 }
@@ -0,0 +1,143 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#include "cppnet/socket/write_lanes.h"
+#include "common/alloter/pool_block.h"
+#include "common/buffer/buffer_queue.h"
+#include "common/alloter/alloter_interface.h"
+
+namespace cppnet {
+
+void WriteLanes::MessageLen::Pop() {
+    _head++;
+    if (_head >= _len.size()) {
+        _len.clear();
+        _head = 0;
+
+    // don't let sent length grow up
+    } else if (_head >= __max_idle_msg_len && _head * 2 >= _len.size()) {
+        _len.erase(_len.begin(), _len.begin() + _head);
+        _head = 0;
+    }
+}
+
+WriteLanes::WriteLanes(const std::shared_ptr<BlockMemoryPool>& block_pool,
+    const std::shared_ptr<AlloterWrap>& alloter):
+    _cur_lane(CWP_NORMAL),
+    _sending(false),
+    _can_read_length(0),
+    _block_pool(block_pool),
+    _alloter(alloter) {
+
+}
+
+WriteLanes::~WriteLanes() {
+    Clear();
+}
+
+uint32_t WriteLanes::Write(const char* data, uint32_t len, uint16_t priority) {
+    if (len == 0) {
+        return 0;
+    }
+
+    uint32_t ret = GetLane(priority)->Write(data, len);
+    if (ret > 0) {
+        _msg_len[priority].Push(ret);
+        _can_read_length += ret;
+    }
+    return ret;
+}
+
+uint32_t WriteLanes::Write(std::shared_ptr<InnerBuffer> buffer, uint32_t len, uint16_t priority) {
+    if (!buffer || buffer->GetCanReadLength() == 0) {
+        return 0;
+    }
+
+    uint32_t ret = GetLane(priority)->Write(buffer, len);
+    if (ret > 0) {
+        _msg_len[priority].Push(ret);
+        _can_read_length += ret;
+    }
+    return ret;
+}
+
+uint32_t WriteLanes::GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size) {
+    if (_can_read_length == 0) {
+        return 0;
+    }
+
+    // finish the partly sent message first
+    if (_sending) {
+        uint32_t left = _msg_len[_cur_lane].Front();
+        if (max_size == 0 || left < max_size) {
+            max_size = left;
+        }
+        return _lanes[_cur_lane]->GetUseMemoryBlock(block_vec, max_size);
+    }
+
+    for (uint16_t i = 0; i < __write_lane_num; i++) {
+        if (!_msg_len[i].Empty()) {
+            _cur_lane = i;
+            break;
+        }
+    }
+    return _lanes[_cur_lane]->GetUseMemoryBlock(block_vec, max_size);
+}
+
+void WriteLanes::MoveReadPt(uint32_t len) {
+    auto& msg_len = _msg_len[_cur_lane];
+    _lanes[_cur_lane]->MoveReadPt(len);
+    _can_read_length -= len;
+
+    while (len > 0 && !msg_len.Empty()) {
+        uint32_t& front = msg_len.Front();
+        if (len < front) {
+            front -= len;
+            _sending = true;
+            return;
+        }
+        len -= front;
+        msg_len.Pop();
+    }
+    _sending = false;
+}
+
+std::shared_ptr<BufferQueue>& WriteLanes::GetLane(uint16_t& priority) {
+    if (priority >= __write_lane_num) {
+        priority = CWP_LOW;
+    }
+
+    // most connections use only one lane, create others when needed
+    auto& lane = _lanes[priority];
+    if (!lane) {
+        lane = _alloter->PoolNewSharePtr<BufferQueue>(_block_pool, _alloter);
+    }
+    return lane;
+}
+
+void WriteLanes::Shrink() {
+    for (uint16_t i = 0; i < __write_lane_num; i++) {
+        if (_lanes[i]) {
+            _lanes[i]->Shrink();
+        }
+        // length list of a burst
+        if (_msg_len[i].Empty() && _msg_len[i]._len.capacity() > __max_idle_msg_len) {
+            _msg_len[i] = MessageLen();
+        }
+    }
+}
+
+void WriteLanes::Clear() {
+    for (uint16_t i = 0; i < __write_lane_num; i++) {
+        if (_lanes[i]) {
+            _lanes[i]->Clear();
+        }
+        _msg_len[i] = MessageLen();
+    }
+    _sending = false;
+    _can_read_length = 0;
+}
+
+}
@@ -0,0 +1,84 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef CPPNET_SOCKET_WRITE_LANES
+#define CPPNET_SOCKET_WRITE_LANES
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "include/cppnet_type.h"
+#include "common/network/io_handle.h"
+#include "common/alloter/alloter_interface.h"
+
+namespace cppnet {
+
+class BufferQueue;
+class InnerBuffer;
+class BlockMemoryPool;
+
+static const uint16_t __write_lane_num = CWP_LOW + 1;
+// message length list longer than this is compacted when half sent
+// and freed when all sent
+static const uint32_t __max_idle_msg_len = 64;
+
+// data waiting to send of one connection, one lane for every priority.
+// data of higher lane is sent first, but only at message boundary:
+// a message, data of one Write call, is never split by another message.
+class WriteLanes {
+public:
+    WriteLanes(const std::shared_ptr<BlockMemoryPool>& block_pool,
+        const std::shared_ptr<AlloterWrap>& alloter);
+    ~WriteLanes();
+
+    uint32_t Write(const char* data, uint32_t len, uint16_t priority = CWP_NORMAL);
+    // move len bytes of buffer to the lane, 0 means all.
+    // blocks of buffer queue are moved by reference, other buffers are copied.
+    uint32_t Write(std::shared_ptr<InnerBuffer> buffer, uint32_t len, uint16_t priority = CWP_NORMAL);
+
+    // bytes of all lanes
+    uint32_t GetCanReadLength() { return _can_read_length; }
+
+    // get data of the lane to send. if a message is partly sent,
+    // return the rest of it only, so a higher lane can go next.
+    uint32_t GetUseMemoryBlock(std::vector<Iovec>& block_vec, uint32_t max_size);
+    // len bytes from GetUseMemoryBlock are sent
+    void MoveReadPt(uint32_t len);
+
+    // give blocks of sent data back to pool
+    void Shrink();
+
+    void Clear();
+
+private:
+    std::shared_ptr<BufferQueue>& GetLane(uint16_t& priority);
+
+    // length of messages in a lane, the first one may be partly sent
+    struct MessageLen {
+        std::vector<uint32_t, PoolAllocator<uint32_t>> _len;
+        uint32_t              _head = 0;
+
+        bool Empty() { return _head >= _len.size(); }
+        uint32_t& Front() { return _len[_head]; }
+        void Push(uint32_t len) { _len.push_back(len); }
+        void Pop();
+    };
+
+    uint16_t _cur_lane;
+    // the first message of current lane is partly sent
+    bool     _sending;
+    uint32_t _can_read_length;
+
+    std::shared_ptr<BufferQueue> _lanes[__write_lane_num];
+    MessageLen                   _msg_len[__write_lane_num];
+
+    std::shared_ptr<BlockMemoryPool> _block_pool;
+    std::shared_ptr<AlloterWrap>     _alloter;
+};
+
+}
+
+#endif
@@ -8,10 +8,12 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cppnet_buffer.h"
 #include "cppnet_socket.h"
 #include "cppnet_type.h"
+#include "cppnet_frame.h"
 
 namespace cppnet {
 
@@ -34,22 +36,58 @@ public:
     void SetReadCallback(read_call_back&& cb);
     void SetWriteCallback(write_call_back&& cb);
     void SetDisconnectionCallback(connect_call_back&& cb);
+    // one call for one frame, if frame decoder is set
+    void SetFrameCallback(frame_call_back&& cb);
+
+    // limit bytes in read and write buffers of all connections.
+    // limit : bytes, 0 means no limit.
+    // policy: CPPNET_MEMORY_POLICY, applied when the limit is reached.
+    void SetMemoryLimit(uint64_t limit, uint16_t policy = CMP_STOP_READ);
+    bool GetMemoryStat(MemoryStat& stat);
 
     // if use socket timer, set it
     void SetTimerCallback(timer_call_back&& cb);
 
     // return timer id
-    uint64_t AddTimer(int32_t interval, user_timer_call_back&& cb, void* param = nullptr, bool always = false);
+    // slack: the timer may be late up to slack milliseconds, so timers
+    // in the same window are run by one wake up of the thread.
+    uint64_t AddTimer(int32_t interval, user_timer_call_back&& cb, void* param = nullptr, bool always = false, uint32_t slack = 0);
+    // interval in microseconds, driven by timerfd of monotonic clock on linux.
+    // other platforms round it up to milliseconds. removed by RemoveTimer.
+    uint64_t AddHighResTimer(uint64_t interval_us, user_timer_call_back&& cb, void* param = nullptr, bool always = false);
     void RemoveTimer(uint64_t timer_id);
+    // one for every network IO thread
+    void GetWakeupStat(std::vector<WakeupStat>& stats);
 
     //server
     void SetAcceptCallback(connect_call_back&& cb);
     bool ListenAndAccept(const std::string& ip, uint16_t port);
+    // limit total send speed of all connections accepted by the listen port.
+    // rate : bytes per second, 0 means no limit.
+    // burst: max bytes can be sent at once, 0 means same as rate.
+    void SetListenSendRate(uint16_t port, uint32_t rate, uint32_t burst = 0);
+    // limit bytes in read and write buffers of connections accepted by the listen port.
+    // limit : bytes, 0 means no limit.
+    // policy: CPPNET_MEMORY_POLICY, applied when the limit is reached.
+    void SetListenMemoryLimit(uint16_t port, uint64_t limit, uint16_t policy = CMP_STOP_READ);
+    // return false if the port is neither listened nor limited
+    bool GetListenMemoryStat(uint16_t port, MemoryStat& stat);
+    // cut frames of connections accepted by the listen port before call back.
+    // every complete frame is delivered by frame call back instead of read call back.
+    // must set before listen, nullptr removes the decoder for new connections.
+    void SetListenFrameDecoder(uint16_t port, std::shared_ptr<FrameDecoder> decoder);
 
     //client
     void SetConnectionCallback(connect_call_back&& cb);
     bool Connection(const std::string& ip, uint16_t port);
 
+    // tls, only valid when cppnet is built with openssl.
+    // accept and connection call back are invoked after handshake.
+    // server: cert_file and key_file are in PEM format.
+    bool ListenAndAcceptTls(const std::string& ip, uint16_t port, const std::string& cert_file, const std::string& key_file);
+    // client: verify server certificate if ca_file is not empty.
+    bool ConnectionTls(const std::string& ip, uint16_t port, const std::string& ca_file = "");
+
 private:
     std::shared_ptr<CppNetBase> _cppnet_base;
 };
@@ -6,10 +6,17 @@
 #ifndef INCLUDE_CPPNET_BUFFER
 #define INCLUDE_CPPNET_BUFFER
 
+#include <vector>
 #include <cstdint>
 
 namespace cppnet {
 
+// continuous readable memory inside buffer
+struct BufferSpan {
+    const char* _data;
+    uint32_t    _len;
+};
+
 class Buffer {
 public:
     Buffer() = default;
@@ -43,6 +50,15 @@ public:
 
     // return can read bytes
     virtual uint32_t FindStr(const char* s, uint32_t s_len) = 0;
+
+    // get readable data in place without copy, one span for each piece of
+    // continuous memory. spans are valid until buffer is read, consumed or written.
+    // max_len: stop when spans cover max_len bytes, 0 means all data.
+    // return total length of spans.
+    virtual uint32_t GetReadableSpans(std::vector<BufferSpan>& spans, uint32_t max_len = 0) = 0;
+    // drop len bytes after they are used in place.
+    // return dropped size.
+    virtual uint32_t Consume(uint32_t len) = 0;
 };
 
 } // namespace cppnet
@@ -0,0 +1,51 @@
+// Use of this source code is governed by a BSD 3-Clause License
+// that can be found in the LICENSE file.
+
+// Author: caozhiyi (caozhiyi5@gmail.com)
+
+#ifndef INCLUDE_CPPNET_FRAME
+#define INCLUDE_CPPNET_FRAME
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+namespace cppnet {
+
+class Buffer;
+
+// cut frames from the head of read buffer before user call back.
+// one decoder is shared by connections on all threads,
+// keep state in the buffer, not in the decoder.
+class FrameDecoder {
+public:
+    FrameDecoder() = default;
+    virtual ~FrameDecoder() = default;
+
+    // return length of the whole frame at the head of buffer, 0 if it's not complete.
+    // header_len : bytes before payload, length field.
+    // trailer_len: bytes after payload, delimiter.
+    // return -1 if data is invalid, the connection will be closed.
+    virtual int32_t Decode(const std::shared_ptr<Buffer>& buffer, uint32_t& header_len, uint32_t& trailer_len) = 0;
+};
+
+// frames longer than this are invalid by default
+static const uint32_t __default_max_frame_len = 16 * 1024 * 1024;
+
+// length field at the head of frame.
+// field_len     : 1, 2, 4 or 8 bytes, 0 means varint, 7 bits each byte and low bits first.
+// big_endian    : byte order of fixed length field.
+// include_header: length counts the field itself.
+std::shared_ptr<FrameDecoder> MakeLengthFrameDecoder(uint8_t field_len, bool big_endian = true,
+    bool include_header = false, uint32_t max_len = __default_max_frame_len);
+
+// frame ends with delimiter.
+std::shared_ptr<FrameDecoder> MakeDelimiterFrameDecoder(const std::string& delimiter,
+    uint32_t max_len = __default_max_frame_len);
+
+// every frame is frame_len bytes.
+std::shared_ptr<FrameDecoder> MakeFixedFrameDecoder(uint32_t frame_len);
+
+} // namespace cppnet
+
+#endif
@@ -6,11 +6,14 @@
 #ifndef INCLUDE_CPPNET_SOCKET
 #define INCLUDE_CPPNET_SOCKET
 
+#include <memory>
 #include <cstdint>
 #include <string>
 
 namespace cppnet {
 
+class Buffer;
+
 // cppnet socket interface
 class CNSocket {
 public:
@@ -23,17 +26,33 @@ public:
     // get socket IP and address
     virtual bool GetAddress(std::string& ip, uint16_t& port) = 0;
 
-    // post sync write event.
+    // post sync write event. can call in any thread, data is copied
+    // and written in the callback thread of the connection then.
     virtual bool Write(const char* src, uint32_t len) = 0;
+    // write with priority, see CPPNET_WRITE_PRIORITY.
+    virtual bool Write(const char* src, uint32_t len, uint16_t priority) = 0;
+    // move len bytes of a received buffer to send, 0 means all. must call in
+    // callback thread of buffer. memory is shared if this connection is of the
+    // same dispatcher, otherwise it's copied and written in its thread.
+    virtual bool Write(std::shared_ptr<Buffer> buffer, uint32_t len = 0) = 0;
+    virtual bool Write(std::shared_ptr<Buffer> buffer, uint32_t len, uint16_t priority) = 0;
     // close the connect
     virtual void Close() = 0;
     
     // add a timer. must set timer call back
-    // interval support max 1 minute
-    virtual void AddTimer(uint32_t interval, bool always = false) = 0;
+    // interval has no limit, it's in milliseconds.
+    // slack: the timer may be late up to slack milliseconds, timers of
+    // many connections are run by one wake up. good for heartbeats.
+    virtual void AddTimer(uint32_t interval, bool always = false, uint32_t slack = 0) = 0;
     // stop the timer
     virtual void StopTimer() = 0;
 
+    // limit send speed of the connection, data over the rate
+    // is cached and sent later. must call in callback thread.
+    // rate : bytes per second, 0 means no limit.
+    // burst: max bytes can be sent at once, 0 means same as rate.
+    virtual void SetSendRate(uint32_t rate, uint32_t burst = 0) = 0;
+
     // set cppnet socket context.
     virtual void SetContext(void* context) = 0;
     // get context.
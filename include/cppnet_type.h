@@ -35,6 +35,11 @@ using write_call_back = std::function<void (Handle, uint32_t)>;
 // data   : point to recv data buffer
 // len    : recv data len
 using read_call_back = std::function<void (Handle, BufferPtr, uint32_t)>;
+
+// handle : handle of socket
+// frame  : payload of one complete frame, valid only in the call back
+// len    : payload len
+using frame_call_back = std::function<void (Handle, const char*, uint32_t)>;
     
 // error code
 enum CPPNET_ERROR_CODE {
@@ -42,6 +47,41 @@ enum CPPNET_ERROR_CODE {
     CEC_CLOSED                 = 1,    // remote close the socket.
     CEC_CONNECT_BREAK          = 2,    // connection break.
     CEC_CONNECT_REFUSE         = 3,    // remote refuse connect or server not exist.
+    CEC_MEMORY_LIMIT           = 4,    // closed by cppnet, buffer memory is over limit.
+    CEC_FRAME_ERROR            = 5,    // closed by cppnet, frame decoder gets invalid data.
+};
+
+// write priority. data of higher priority is sent first,
+// but data of one Write call is never split by others.
+enum CPPNET_WRITE_PRIORITY {
+    CWP_HIGH                   = 0,    // control message, heartbeat, cancel.
+    CWP_NORMAL                 = 1,    // default.
+    CWP_LOW                    = 2,    // bulk data.
+};
+
+// what to do when buffer memory is over limit.
+// memory is bytes of data in read and write buffers of connections.
+enum CPPNET_MEMORY_POLICY {
+    CMP_STOP_READ              = 0,    // stop reading sockets until memory is under limit.
+    CMP_REJECT_WRITE           = 1,    // Write returns false.
+    CMP_CLOSE_LARGEST          = 2,    // close connections holding at least average bytes when they read or write.
+};
+
+// buffer memory of all connections, or of connections of a listen port.
+struct MemoryStat {
+    uint64_t _used_bytes;       // bytes in read and write buffers
+    uint64_t _limit_bytes;      // 0 means no limit
+    uint16_t _policy;           // CPPNET_MEMORY_POLICY
+    uint32_t _connections;
+    uint64_t _stopped_reads;    // times a connection stopped reading
+    uint64_t _rejected_writes;  // times Write returned false
+    uint64_t _closed_connections;
+};
+
+// wake ups of one network IO thread
+struct WakeupStat {
+    uint64_t _wakeups;          // total times the thread woke up
+    uint32_t _wakeups_per_sec;  // wake ups of the last second, updated when woke up
 };
 
 } // namespace cppnet
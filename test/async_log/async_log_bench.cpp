@@ -0,0 +1,92 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include "common/log/log.h"
+#include "common/log/file_logger.h"
+#include "common/log/async_file_logger.h"
+
+using namespace cppnet;
+
+// many threads log debug lines at the same time like dispatchers with debug log.
+// file logger pushes every log to one queue with lock, async logger copies it
+// to the ring of the thread. defer keeps binary logs and the writer thread formats
+// them, binary writes binary logs to file which is read by log decoder.
+// limit prints 10 logs a second of the call site and sample prints one of 100 logs,
+// they show the cost of the logs in hot paths which are mostly not printed.
+// run: asynclogbench [file|async|defer|binary|limit|sample] [thread num] [logs per thread] [block when full 0|1]
+
+static void LogThread(uint32_t num) {
+    for (uint32_t i = 0; i < num; i++) {
+        LOG_DEBUG("recv data from socket. sock:%d, len:%d, count:%u", 1024, 4096, i);
+    }
+}
+
+static void LimitLogThread(uint32_t num) {
+    for (uint32_t i = 0; i < num; i++) {
+        LOG_DEBUG_LIMIT(10, 1000, "recv data from socket. sock:%d, len:%d, count:%u", 1024, 4096, i);
+    }
+}
+
+static void SampleLogThread(uint32_t num) {
+    for (uint32_t i = 0; i < num; i++) {
+        LOG_DEBUG_SAMPLE(100, "recv data from socket. sock:%d, len:%d, count:%u", 1024, 4096, i);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string type = argc > 1 ? argv[1] : "async";
+    uint32_t thread_num = argc > 2 ? (uint32_t)atoi(argv[2]) : 16;
+    uint32_t log_num = argc > 3 ? (uint32_t)atoi(argv[3]) : 200000;
+    bool block = argc > 4 ? atoi(argv[4]) != 0 : false;
+
+    std::shared_ptr<Logger> logger;
+    std::shared_ptr<FileLogger> file_logger;
+    std::shared_ptr<AsyncFileLogger> async_logger;
+    if (type == "file") {
+        file_logger = std::make_shared<FileLogger>("filelogbench");
+        logger = file_logger;
+
+    } else {
+        async_logger = std::make_shared<AsyncFileLogger>("asynclogbench", FLSU_DAY, 3, 5,
+            1024 * 128, block ? LFP_BLOCK : LFP_DROP, type == "binary");
+        logger = async_logger;
+    }
+    LOG_SET(logger);
+    LOG_SET_LEVEL(LL_DEBUG);
+    LOG_SET_DEFER_FORMAT(type == "defer" || type == "binary");
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < thread_num; i++) {
+        threads.emplace_back(type == "limit" ? LimitLogThread :
+            (type == "sample" ? SampleLogThread : LogThread), log_num);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto log_end = std::chrono::steady_clock::now();
+
+    // wait all logs are written, file logger drops the queue when it stops
+    while (file_logger && file_logger->GetQueueSize() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    uint64_t drop_num = async_logger ? async_logger->GetDropNum() : 0;
+    LOG_SET(nullptr);
+    logger.reset();
+    file_logger.reset();
+    async_logger.reset();
+    auto write_end = std::chrono::steady_clock::now();
+
+    uint64_t total = (uint64_t)thread_num * log_num;
+    double log_ns = std::chrono::duration<double, std::nano>(log_end - start).count();
+    double write_ms = std::chrono::duration<double, std::milli>(write_end - start).count();
+    std::cout << type << " logger, threads: " << thread_num << ", logs: " << total
+              << (type == "file" ? "" : (block ? ", block when full" : ", drop when full")) << std::endl;
+    std::cout << "  log     : " << log_ns / total << " ns/log of all threads" << std::endl;
+    std::cout << "  written : " << write_ms << " ms, " << (total - drop_num) * 1000 / write_ms << " logs/s" << std::endl;
+    std::cout << "  dropped : " << drop_num << std::endl;
+}
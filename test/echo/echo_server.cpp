@@ -8,16 +8,15 @@
 
 using namespace cppnet;
 
-static const int __buf_len = 2048;
 static const char* __buf_spilt = "\r\n";
 
 void ReadFunc(Handle handle, cppnet::BufferPtr data, uint32_t len) {
-    char msg_buf[__buf_len] = {0};
-    uint32_t need_len = 0;
     uint32_t find_len = (uint32_t)strlen(__buf_spilt);
-    // get recv data to send back.
-    uint32_t size = data->ReadUntil(msg_buf, __buf_len, __buf_spilt, find_len, need_len);
-    handle->Write(msg_buf, size);
+    // send back the first line, received memory is shared without copy.
+    uint32_t size = data->FindStr(__buf_spilt, find_len);
+    if (size > 0) {
+        handle->Write(data, size);
+    }
 }
 
 void ConnectFunc(Handle handle, uint32_t error) {
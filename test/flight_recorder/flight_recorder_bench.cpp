@@ -0,0 +1,70 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#ifndef __win__
+#include <signal.h>
+#endif
+
+#include "common/log/log.h"
+#include "common/log/flight_recorder.h"
+
+using namespace cppnet;
+
+// log print is off and threads log debug lines like dispatchers do. with record
+// on, the flight recorder keeps recent logs of every thread in memory. at last
+// the logs are dumped by LOG_DUMP_RECORD and by SIGUSR1.
+// run: flightrecorderbench [thread num] [logs per thread] [record 0|1]
+
+static void LogThread(uint32_t num, uint32_t id) {
+    for (uint32_t i = 0; i < num; i++) {
+        LOG_DEBUG("recv data from socket. sock:%u, len:%d, count:%u", id, 4096, i);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t thread_num = argc > 1 ? (uint32_t)atoi(argv[1]) : 16;
+    uint32_t log_num = argc > 2 ? (uint32_t)atoi(argv[2]) : 200000;
+    bool record = argc > 3 ? atoi(argv[3]) != 0 : true;
+
+    LOG_SET_LEVEL(LL_NULL);
+    auto recorder = std::make_shared<FlightRecorder>("flightrecorderbench", 1024);
+    if (record) {
+        LOG_SET_RECORDER(recorder);
+        LOG_SET_RECORD_LEVEL(LL_DEBUG);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < thread_num; i++) {
+        threads.emplace_back(LogThread, log_num, i);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    uint64_t total = (uint64_t)thread_num * log_num;
+    double log_ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << (record ? "record" : "no record") << ", threads: " << thread_num << ", logs: " << total << std::endl;
+    std::cout << "  log  : " << log_ns / total << " ns/log of all threads" << std::endl;
+    if (!record) {
+        return 0;
+    }
+
+    start = std::chrono::steady_clock::now();
+    std::string file = LOG_DUMP_RECORD();
+    end = std::chrono::steady_clock::now();
+    std::cout << "  dump : " << file << ", " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+#ifndef __win__
+    // the recorder thread dumps again
+    if (recorder->DumpOnSignal(SIGUSR1)) {
+        raise(SIGUSR1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::cout << "  dump on SIGUSR1 is done" << std::endl;
+    }
+#endif
+    LOG_SET_RECORDER(nullptr);
+}
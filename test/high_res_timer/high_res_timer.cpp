@@ -0,0 +1,73 @@
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+// interval between call backs of a periodic high resolution timer and a
+// periodic timer of the timer wheel, and how far it is from the expected one.
+// run: highrestimer [interval us] [run seconds]
+
+class IntervalStat {
+public:
+    IntervalStat(uint64_t interval_us): _interval_us(interval_us), _num(0), _total_us(0), _total_error_us(0), _max_error_us(0) {}
+
+    void OnTimer() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto now = std::chrono::steady_clock::now();
+        if (_num++ > 0) {
+            int64_t interval = std::chrono::duration_cast<std::chrono::microseconds>(now - _last).count();
+            uint64_t error = (uint64_t)(interval > (int64_t)_interval_us ? interval - _interval_us : _interval_us - interval);
+            _total_us += interval;
+            _total_error_us += error;
+            if (error > _max_error_us) {
+                _max_error_us = error;
+            }
+        }
+        _last = now;
+    }
+
+    void Print(const std::string& name) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        uint64_t num = _num > 1 ? _num - 1 : 1;
+        std::cout << name << " : " << _num << " call backs, average interval " << _total_us / num
+                  << " us, average error " << _total_error_us / num << " us, max error " << _max_error_us << " us" << std::endl;
+    }
+
+private:
+    std::mutex _mutex;
+    uint64_t _interval_us;
+    uint64_t _num;
+    uint64_t _total_us;
+    uint64_t _total_error_us;
+    uint64_t _max_error_us;
+    std::chrono::steady_clock::time_point _last;
+};
+
+int main(int argc, char** argv) {
+    uint64_t interval_us = argc > 1 ? (uint64_t)atoll(argv[1]) : 1000;
+    uint32_t run_sec = argc > 2 ? (uint32_t)atoi(argv[2]) : 5;
+
+    cppnet::CppNet net;
+    net.Init(1);
+
+    IntervalStat high_res(interval_us);
+    IntervalStat wheel((interval_us + 999) / 1000 * 1000);
+
+    uint64_t high_res_id = net.AddHighResTimer(interval_us, [&high_res](void*) { high_res.OnTimer(); }, nullptr, true);
+    uint64_t wheel_id = net.AddTimer((int32_t)((interval_us + 999) / 1000), [&wheel](void*) { wheel.OnTimer(); }, nullptr, true);
+
+    std::this_thread::sleep_for(std::chrono::seconds(run_sec));
+    net.RemoveTimer(high_res_id);
+    net.RemoveTimer(wheel_id);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::cout << "interval " << interval_us << " us, run " << run_sec << " s" << std::endl;
+    high_res.Print("high resolution timer");
+    wheel.Print("timer wheel          ");
+    net.Destory();
+}
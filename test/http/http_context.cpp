@@ -40,17 +40,54 @@ bool HttpContext::processRequestLine(const char* begin, const char* end) {
     return succeed;
 }
 
+bool HttpContext::getLine(cppnet::BufferPtr buf, const char*& begin, const char*& end) {
+    _in_place_len = 0;
+    _spans.clear();
+    buf->GetReadableSpans(_spans, sizeof(_line_buf));
+    if (_spans.empty()) {
+        return false;
+    }
+
+    // most lines are in the first span, parse there
+    const char* data = _spans[0]._data;
+    const char* data_end = data + _spans[0]._len;
+    const char* crlf = std::search(data, data_end, CRLF, CRLF + CRLF_LEN);
+    if (crlf != data_end) {
+        begin = data;
+        end = crlf;
+        _in_place_len = uint32_t(crlf - data) + CRLF_LEN;
+        return true;
+    }
+
+    // line crosses blocks, copy it
+    uint32_t need_len = 0;
+    uint32_t size = buf->ReadUntil(_line_buf, sizeof(_line_buf), CRLF, CRLF_LEN, need_len);
+    if (size == 0) {
+        return false;
+    }
+    begin = _line_buf;
+    end = _line_buf + size - CRLF_LEN;
+    return true;
+}
+
+void HttpContext::consumeLine(cppnet::BufferPtr buf) {
+    if (_in_place_len > 0) {
+        buf->Consume(_in_place_len);
+        _in_place_len = 0;
+    }
+}
+
 // return false if any error
 bool HttpContext::ParseRequest(cppnet::BufferPtr buf, uint64_t receive_time) {
     bool ok = true;
     bool hasMore = true;
+    const char* begin = nullptr;
+    const char* end = nullptr;
     while (hasMore) {
         if (_state == ExpectRequestLine) {
-            char line_buf[1024] = {0};
-            uint32_t need_len = 0;
-            uint32_t size = buf->ReadUntil(line_buf, 1024, CRLF, CRLF_LEN, need_len);
-            if (size > 0) {
-                ok = processRequestLine(line_buf, line_buf + size);
+            if (getLine(buf, begin, end)) {
+                ok = processRequestLine(begin, end + CRLF_LEN);
+                consumeLine(buf);
                 if (ok) {
                     _request.SetReceiveTime(receive_time);
                     _state = ExpectHeaders;
@@ -64,14 +101,10 @@ bool HttpContext::ParseRequest(cppnet::BufferPtr buf, uint64_t receive_time) {
             }
 
         } else if (_state == ExpectHeaders) {
-            char line_buf[1024] = { 0 };
-            uint32_t need_len = 0;
-            uint32_t size = buf->ReadUntil(line_buf, 1024, CRLF, CRLF_LEN, need_len);
-            char* end = line_buf + size - CRLF_LEN;
-            if (size > 0) {
-                const char* colon = std::find(line_buf, end, ':');
+            if (getLine(buf, begin, end)) {
+                const char* colon = std::find(begin, end, ':');
                 if (colon != end) {
-                    _request.AddHeader(line_buf, colon, end);
+                    _request.AddHeader(begin, colon, end);
 
                 } else {
                     // empty line, end of header
@@ -79,6 +112,7 @@ bool HttpContext::ParseRequest(cppnet::BufferPtr buf, uint64_t receive_time) {
                     _state = GotAll;
                     hasMore = false;
                 }
+                consumeLine(buf);
 
             } else {
                 hasMore = false;
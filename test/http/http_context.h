@@ -1,8 +1,10 @@
 #ifndef TEST_HTTP_HTTP_CONTEXT_HEADER
 #define TEST_HTTP_HTTP_CONTEXT_HEADER
 
+#include <vector>
 #include "http_request.h"
 #include "include/cppnet_type.h"
+#include "include/cppnet_buffer.h"
 
 enum HttpRequestParseState{
     ExpectRequestLine,
@@ -44,9 +46,18 @@ class HttpContext {
 
     private:
         bool processRequestLine(const char* begin, const char* end);
+        // get a line end with CRLF, without CRLF. return false if no complete line.
+        // the line points into buffer if it's in one continuous memory, call
+        // consumeLine after use. otherwise it's copied to line_buf.
+        bool getLine(cppnet::BufferPtr buf, const char*& begin, const char*& end);
+        void consumeLine(cppnet::BufferPtr buf);
     private:
         HttpRequestParseState _state;
         HttpRequest _request;
+        // line length to consume if the line is in place
+        uint32_t _in_place_len = 0;
+        char _line_buf[1024];
+        std::vector<cppnet::BufferSpan> _spans;
 };
 
 #endif
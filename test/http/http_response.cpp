@@ -1,6 +1,7 @@
 #include <string>
 #include <stdio.h>
 #include "http_response.h"
+#include "common/util/time.h"
 
 std::string HttpResponse::GetSendBuffer() const {
     std::string ret;
@@ -10,6 +11,16 @@ std::string HttpResponse::GetSendBuffer() const {
     ret.append(_status_message);
     ret.append("\r\n");
 
+    // date is formatted once a second
+    if (_headers_map.find("Date") == _headers_map.end()) {
+        char date[cppnet::__http_date_buf_size];
+        uint32_t date_len = cppnet::__http_date_buf_size;
+        cppnet::GetHttpDate(date, date_len);
+        ret.append("Date: ");
+        ret.append(date, date_len);
+        ret.append("\r\n");
+    }
+
     if (_close_connection) {
         ret.append("Connection: close\r\n");
 
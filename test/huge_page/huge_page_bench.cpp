@@ -0,0 +1,121 @@
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+#include "common/alloter/pool_block.h"
+#include "common/alloter/pool_alloter.h"
+#include "common/alloter/huge_page_arena.h"
+
+using namespace cppnet;
+
+// tlb impact of huge page arenas. blocks and small objects are linked in
+// random order and chased one by one, every hop is likely a tlb miss
+// with normal pages. run: hugepagebench [block num] [object num] [hops]
+
+static const uint32_t __block_size  = 1024;
+static const uint32_t __object_size = 64;
+
+// anonymous memory backed by huge pages of the process in bytes
+static uint64_t HugePageMemory() {
+    FILE* file = fopen("/proc/self/smaps_rollup", "r");
+    if (!file) {
+        return 0;
+    }
+    char line[256];
+    unsigned long kb = 0;
+    uint64_t total = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1 ||
+            sscanf(line, "Private_Hugetlb: %lu kB", &kb) == 1) {
+            total += kb;
+        }
+    }
+    fclose(file);
+    return total * 1024;
+}
+
+// link nodes in random order, return nanoseconds per hop
+static double Chase(std::vector<void*>& nodes, uint64_t hops) {
+    std::vector<void*> order(nodes);
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    for (size_t i = 0; i < order.size(); i++) {
+        *(void**)order[i] = order[(i + 1) % order.size()];
+    }
+
+    void* cur = order[0];
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < hops; i++) {
+        cur = *(void**)cur;
+    }
+    auto end = std::chrono::steady_clock::now();
+    // keep the chase
+    if (cur == nullptr) {
+        std::cout << "never" << std::endl;
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count() / hops;
+}
+
+static void Run(const std::string& name, std::shared_ptr<HugePageArena> arena,
+    uint32_t block_num, uint32_t object_num, uint64_t hops) {
+    uint64_t huge_before = HugePageMemory();
+
+    auto pool = MakeBlockMemoryPoolPtr(__block_size, 64, 1, arena);
+    std::vector<void*> blocks;
+    blocks.reserve(block_num);
+    for (uint32_t i = 0; i < block_num; i++) {
+        void* block = pool->PoolLargeMalloc();
+        if (!block) {
+            std::cout << name << " out of memory" << std::endl;
+            return;
+        }
+        memset(block, 0, __block_size);
+        blocks.push_back(block);
+    }
+
+    auto alloter = MakePoolAlloterPtr(arena);
+    std::vector<void*> objects;
+    objects.reserve(object_num);
+    for (uint32_t i = 0; i < object_num; i++) {
+        void* object = alloter->Malloc(__object_size);
+        memset(object, 0, __object_size);
+        objects.push_back(object);
+    }
+
+    double block_ns = Chase(blocks, hops);
+    double object_ns = Chase(objects, hops);
+    uint64_t huge = HugePageMemory() - huge_before;
+
+    std::cout << name << std::endl;
+    std::cout << "  block chase  : " << block_ns << " ns/hop" << std::endl;
+    std::cout << "  object chase : " << object_ns << " ns/hop" << std::endl;
+    std::cout << "  huge pages   : " << huge / 1024 << " KB" << std::endl;
+    if (arena) {
+        std::cout << "  arenas       : reserved " << arena->GetArenaNum(HPT_EXPLICIT)
+                  << ", transparent " << arena->GetArenaNum(HPT_TRANSPARENT)
+                  << ", normal " << arena->GetArenaNum(HPT_NORMAL) << std::endl;
+    }
+
+    for (auto& block : blocks) {
+        pool->PoolLargeFree(block);
+    }
+    for (auto& object : objects) {
+        alloter->Free(object, __object_size);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t block_num = argc > 1 ? (uint32_t)atoi(argv[1]) : 128 * 1024;
+    uint32_t object_num = argc > 2 ? (uint32_t)atoi(argv[2]) : 1024 * 1024;
+    uint64_t hops = argc > 3 ? (uint64_t)atoll(argv[3]) : 20 * 1000 * 1000;
+
+    std::cout << "blocks: " << block_num << " x " << __block_size << " bytes, objects: "
+              << object_num << " x " << __object_size << " bytes, hops: " << hops << std::endl;
+    Run("malloc", nullptr, block_num, object_num, hops);
+    Run("huge page arena", MakeHugePageArenaPtr(), block_num, object_num, hops);
+}
@@ -0,0 +1,155 @@
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+// memory used by idle connections on server side.
+// every connection sends one request and gets the response,
+// then keeps idle. run: idlememory [connection num] [message size] [wait seconds]
+// if wait seconds is set, every connection sends a large message at the same time
+// and reads the response later, memory is read again after the spike and after
+// wait seconds, pools are trimmed in this time.
+
+static const uint16_t __port = 8925;
+static const uint32_t __spike_size = 1024 * 1024;
+static std::atomic<uint32_t> __accept_num(0);
+
+// resident memory of the process in bytes
+static uint64_t ResidentMemory() {
+    unsigned long pages = 0, resident = 0;
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    if (fscanf(file, "%lu %lu", &pages, &resident) != 2) {
+        resident = 0;
+    }
+    fclose(file);
+    return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+void AcceptFunc(Handle handle, uint32_t error) {
+    if (error == CEC_SUCCESS) {
+        __accept_num++;
+    }
+}
+
+void ReadFunc(Handle handle, cppnet::BufferPtr data, uint32_t len) {
+    // echo the request
+    handle->Write(data);
+}
+
+int main(int argc, char** argv) {
+    uint32_t conn_num = argc > 1 ? (uint32_t)atoi(argv[1]) : 10000;
+    uint32_t msg_size = argc > 2 ? (uint32_t)atoi(argv[2]) : 512;
+    uint32_t wait_sec = argc > 3 ? (uint32_t)atoi(argv[3]) : 0;
+
+    // client and server sockets are in this process
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    if (limit.rlim_cur < conn_num * 2 + 64) {
+        conn_num = (uint32_t)(limit.rlim_cur - 64) / 2;
+        std::cout << "open file limit, reduce connection num to " << conn_num << std::endl;
+    }
+
+    cppnet::CppNet net;
+    net.Init(4);
+    net.SetAcceptCallback(AcceptFunc);
+    net.SetReadCallback(ReadFunc);
+    net.ListenAndAccept("0.0.0.0", __port);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    uint64_t base = ResidentMemory();
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(__port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+    std::string msg(msg_size, 'x');
+    std::vector<char> recv_buf(msg_size);
+    std::vector<int> clients;
+    clients.reserve(conn_num);
+    for (uint32_t i = 0; i < conn_num; i++) {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock < 0 || connect(sock, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            std::cout << "connect failed at " << i << ", errno:" << errno << std::endl;
+            if (sock >= 0) {
+                close(sock);
+            }
+            break;
+        }
+        send(sock, msg.data(), msg.length(), 0);
+        uint32_t recv_len = 0;
+        while (recv_len < msg_size) {
+            ssize_t ret = recv(sock, recv_buf.data(), msg_size - recv_len, 0);
+            if (ret <= 0) {
+                break;
+            }
+            recv_len += (uint32_t)ret;
+        }
+        clients.push_back(sock);
+    }
+
+    while (__accept_num < clients.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    uint64_t used = ResidentMemory() - base;
+    std::cout << "idle connections : " << clients.size() << std::endl;
+    std::cout << "resident memory  : " << used / 1024 << " KB" << std::endl;
+    if (!clients.empty()) {
+        std::cout << "per connection   : " << used / clients.size() << " bytes" << std::endl;
+    }
+
+    if (wait_sec > 0 && !clients.empty()) {
+        // responses are kept by server until clients read
+        std::string spike(__spike_size, 'x');
+        for (auto sock : clients) {
+            send(sock, spike.data(), spike.length(), 0);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::cout << "spike peak       : " << (ResidentMemory() - base) / 1024 << " KB" << std::endl;
+
+        recv_buf.resize(__spike_size);
+        for (auto sock : clients) {
+            uint32_t recv_len = 0;
+            while (recv_len < __spike_size) {
+                ssize_t ret = recv(sock, recv_buf.data(), __spike_size - recv_len, 0);
+                if (ret <= 0) {
+                    break;
+                }
+                recv_len += (uint32_t)ret;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::cout << "after spike      : " << (ResidentMemory() - base) / 1024 << " KB" << std::endl;
+
+        std::this_thread::sleep_for(std::chrono::seconds(wait_sec));
+        std::cout << "after " << wait_sec << " seconds  : " << (ResidentMemory() - base) / 1024 << " KB" << std::endl;
+    }
+
+    for (auto sock : clients) {
+        close(sock);
+    }
+    net.Destory();
+}
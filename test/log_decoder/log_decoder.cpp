@@ -0,0 +1,72 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#include "common/log/binary_log.h"
+
+using namespace cppnet;
+
+// print binary log file written by async file logger as text logs.
+// run: logdecoder [binary log file]
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: logdecoder [binary log file]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::in | std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint32_t magic_len = sizeof(__binary_log_file_magic) - 1;
+    if (data.size() < magic_len || memcmp(data.data(), __binary_log_file_magic, magic_len) != 0) {
+        std::cerr << argv[1] << " is not a binary log file" << std::endl;
+        return 1;
+    }
+
+    // format strings and file names by address
+    std::unordered_map<uint64_t, std::string> strings;
+    char text[__binary_log_text_size];
+    size_t pos = magic_len;
+    while (pos + sizeof(uint8_t) + sizeof(uint32_t) <= data.size()) {
+        uint8_t type = (uint8_t)data[pos];
+        uint32_t len = 0;
+        memcpy(&len, data.data() + pos + sizeof(type), sizeof(len));
+        pos += sizeof(type) + sizeof(len);
+        if (pos + len > data.size()) {
+            std::cerr << "the last record is broken" << std::endl;
+            break;
+        }
+
+        const char* record = data.data() + pos;
+        pos += len;
+        switch (type) {
+        case BLFR_STRING: {
+            uint64_t addr = 0;
+            memcpy(&addr, record, sizeof(addr));
+            strings[addr] = std::string(record + sizeof(addr), len - sizeof(addr));
+            break;
+        }
+        case BLFR_BINARY: {
+            if (!IsBinaryLog(record, len)) {
+                break;
+            }
+            BinaryLogHead head = GetBinaryLogHead(record);
+            uint32_t text_len = FormatBinaryLog(record, len, strings[head._format].c_str(),
+                strings[head._file].c_str(), text, __binary_log_text_size);
+            std::cout.write(text, text_len);
+            std::cout << '\n';
+            break;
+        }
+        case BLFR_TEXT:
+            std::cout.write(record, len);
+            std::cout << '\n';
+            break;
+        default:
+            break;
+        }
+    }
+    return 0;
+}
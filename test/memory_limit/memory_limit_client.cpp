@@ -0,0 +1,55 @@
+#include <string>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+static const uint16_t __port = 8926;
+static const uint32_t __conn_num = 8;
+// slow consumers, each stops reading when it holds 4M
+static const uint64_t __memory_limit = __conn_num * 4 * 1024 * 1024;
+
+static const std::string __data(256 * 1024, 'x');
+
+void WriteMore(Handle handle) {
+    // send until cppnet's write cache is full
+    while (handle->Write(__data.c_str(), (uint32_t)__data.length())) {}
+}
+
+void ConnectFunc(Handle handle, uint32_t err) {
+    if (err != CEC_SUCCESS) {
+        std::cout << "connect failed : " << err << std::endl;
+        return;
+    }
+    WriteMore(handle);
+}
+
+void WriteFunc(Handle handle, uint32_t len) {
+    WriteMore(handle);
+}
+
+void ReadFunc(Handle handle, BufferPtr data, uint32_t len) {
+    // never read the data
+}
+
+void DisConnectionFunc(Handle handle, uint32_t err) {
+    std::cout << "connection closed : " << handle->GetSocket() << " err : " << err << std::endl;
+}
+
+int main() {
+    cppnet::CppNet net;
+    net.Init(1);
+
+    net.SetConnectionCallback(ConnectFunc);
+    net.SetWriteCallback(WriteFunc);
+    net.SetReadCallback(ReadFunc);
+    net.SetDisconnectionCallback(DisConnectionFunc);
+
+    net.SetMemoryLimit(__memory_limit, CMP_STOP_READ);
+    for (uint32_t i = 0; i < __conn_num; i++) {
+        net.Connection("127.0.0.1", __port);
+    }
+
+    net.Join();
+}
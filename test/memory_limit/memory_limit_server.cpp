@@ -0,0 +1,58 @@
+#include <string>
+#include <cstring>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+static const uint16_t __port = 8926;
+// buffers of all connections of the port can't hold more than 16M
+static const uint64_t __listen_memory_limit = 16 * 1024 * 1024;
+
+static cppnet::CppNet __net;
+
+void ReadFunc(Handle handle, BufferPtr data, uint32_t len) {
+    // echo without copy, drop the data if it's rejected
+    if (!handle->Write(data)) {
+        data->Clear();
+    }
+}
+
+void DisConnectionFunc(Handle handle, uint32_t err) {
+    if (err == CEC_MEMORY_LIMIT) {
+        std::cout << "connection closed by memory limit : " << handle->GetSocket() << std::endl;
+    }
+}
+
+void PrintStat(void*) {
+    MemoryStat stat;
+    if (!__net.GetListenMemoryStat(__port, stat)) {
+        return;
+    }
+    std::cout << "used:" << stat._used_bytes / 1024 << "K limit:" << stat._limit_bytes / 1024
+        << "K connections:" << stat._connections << " stopped reads:" << stat._stopped_reads
+        << " rejected writes:" << stat._rejected_writes << " closed:" << stat._closed_connections << std::endl;
+}
+
+// usage: memorylimitserver [stop|reject|close]
+int main(int argc, char** argv) {
+    uint16_t policy = CMP_STOP_READ;
+    if (argc > 1 && strcmp(argv[1], "reject") == 0) {
+        policy = CMP_REJECT_WRITE;
+
+    } else if (argc > 1 && strcmp(argv[1], "close") == 0) {
+        policy = CMP_CLOSE_LARGEST;
+    }
+
+    __net.Init(2);
+
+    __net.SetReadCallback(ReadFunc);
+    __net.SetDisconnectionCallback(DisConnectionFunc);
+
+    __net.SetListenMemoryLimit(__port, __listen_memory_limit, policy);
+    __net.ListenAndAccept("0.0.0.0", __port);
+    __net.AddTimer(1000, PrintStat, nullptr, true);
+
+    __net.Join();
+}
@@ -27,12 +27,8 @@ void OnConnection(const cppnet::Handle& handle, uint32_t error) {
 }
 
 void OnMessage(const cppnet::Handle& handle, cppnet::BufferPtr data, uint32_t) {
-    char buff[65535];
-    
-    while (data->GetCanReadLength()) {
-        int ret = data->Read(buff, 65535);
-        handle->Write(buff, ret);
-    }
+    // send back received blocks, no copy
+    handle->Write(data);
 }
 
 int main() {
@@ -0,0 +1,51 @@
+#include <atomic>
+#include <string>
+#include <iostream>
+
+#include "include/cppnet.h"
+#include "common/util/time.h"
+
+using namespace cppnet;
+
+static const int __client_count = 4;
+static const int __run_seconds = 5;
+
+std::atomic<uint64_t> __recv_len[__client_count];
+std::atomic_int __index(0);
+
+void ReadFunc(Handle handle, cppnet::BufferPtr data, uint32_t len) {
+    auto index = (uint64_t)handle->GetContext();
+    __recv_len[index] += len;
+    data->Clear();
+}
+
+void ConnectFunc(Handle handle, uint32_t error) {
+    if (error != CEC_SUCCESS) {
+        std::cout << "something err while connect : " << error << std::endl;
+        return;
+    }
+    handle->SetContext((void*)(uint64_t)__index++);
+}
+
+int main() {
+    cppnet::CppNet net;
+    net.Init(1);
+
+    net.SetConnectionCallback(ConnectFunc);
+    net.SetReadCallback(ReadFunc);
+
+    for (int i = 0; i < __client_count; i++) {
+        __recv_len[i] = 0;
+        net.Connection("127.0.0.1", 8924);
+    }
+
+    cppnet::Sleep(__run_seconds * 1000);
+
+    uint64_t total = 0;
+    for (int i = 0; i < __client_count; i++) {
+        std::cout << "connection " << i << " : " << __recv_len[i] / __run_seconds / 1024 << " KB/s" << std::endl;
+        total += __recv_len[i];
+    }
+    std::cout << "total : " << total / __run_seconds / 1024 << " KB/s" << std::endl;
+    net.Destory();
+}
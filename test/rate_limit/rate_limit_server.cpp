@@ -0,0 +1,59 @@
+#include <string>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+static const uint16_t __port = 8924;
+// all connections share 1M/s
+static const uint32_t __listen_rate = 1024 * 1024;
+// one connection can't use more than 512K/s
+static const uint32_t __conn_rate = 512 * 1024;
+// data to send to each connection
+static const uint32_t __send_size = 4 * 1024 * 1024;
+
+static const std::string __data(64 * 1024, 'x');
+
+void WriteMore(Handle handle) {
+    uint64_t sent = (uint64_t)handle->GetContext();
+    // cppnet caches data over the rate, keep a few chunks in it
+    while (sent < __send_size && handle->Write(__data.c_str(), (uint32_t)__data.length())) {
+        sent += __data.length();
+        if (sent % (256 * 1024) == 0) {
+            break;
+        }
+    }
+    handle->SetContext((void*)sent);
+}
+
+void WriteFunc(Handle handle, uint32_t len) {
+    WriteMore(handle);
+}
+
+void AcceptFunc(Handle handle, uint32_t error) {
+    if (error != CEC_SUCCESS) {
+        return;
+    }
+    handle->SetSendRate(__conn_rate);
+    handle->SetContext((void*)0);
+    WriteMore(handle);
+}
+
+void DisConnectionFunc(Handle handle, uint32_t err) {
+    std::cout << "connection closed : " << handle->GetSocket() << std::endl;
+}
+
+int main() {
+    cppnet::CppNet net;
+    net.Init(2);
+
+    net.SetAcceptCallback(AcceptFunc);
+    net.SetWriteCallback(WriteFunc);
+    net.SetDisconnectionCallback(DisConnectionFunc);
+
+    net.SetListenSendRate(__port, __listen_rate);
+    net.ListenAndAccept("0.0.0.0", __port);
+
+    net.Join();
+}
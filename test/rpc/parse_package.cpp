@@ -106,13 +106,15 @@ bool ParsePackage::ParseFuncRet(char* buf, int len, int& code, std::string& func
     return true;
 }
 
-bool ParsePackage::ParseFuncCall(char* buf, int len, std::string& func_name, const std::map<std::string, std::string>& func_str_map, std::vector<cppnet::Any>& res) {
-    if (!buf) {
+bool ParsePackage::ParseFuncCall(const char* buf, int len, std::string& func_name, const std::map<std::string, std::string>& func_str_map, std::vector<cppnet::Any>& res) {
+    if (!buf || len < 0) {
         return false;
     }
-    char* end = buf + len;
-    char* next = buf;
-    char* pos = nullptr;
+    const char* end = buf + len;
+    const char* next = buf;
+    const char* pos = nullptr;
+    // one field, the parsers want it null terminated
+    std::string field;
     char* cur = nullptr;
 
     int state = PARSE_NAME;
@@ -120,17 +122,14 @@ bool ParsePackage::ParseFuncCall(char* buf, int len, std::string& func_name, con
     std::string func_str;
     size_t index = 0;
     for (;;) {
-        cur = next;
-        if (strcmp(cur, "\r\n\r\n") == 0) {
+        if (next == end) {
             return true;
         }
-        if (cur > end) {
-            return false;
-        }
-        pos = strchr(cur, '|');
+        pos = (const char*)memchr(next, '|', end - next);
         if (pos) {
+            field.assign(next, pos - next);
+            cur = &field[0];
             next = pos + 1;
-            *pos = '\0';
 
         } else {
             return false;
@@ -507,7 +506,7 @@ bool ParsePackage::_ParseParam(char* buf, char type, std::vector<cppnet::Any>& r
         res.push_back(cppnet::Any(atoi(cur + 2)));
         break;
     case 'c':
-        res.push_back(cppnet::Any(cur + 2));
+        res.push_back(cppnet::Any(*(cur + 2)));
         break;
     case 's':
         res.push_back(cppnet::Any(std::string(cur + 2)));
@@ -45,7 +45,8 @@ public:
     bool ParseType(char* buf, int len, int& type);
     //parase for every type
     bool ParseFuncRet(char* buf, int len, int& code, std::string& func_name, const std::map<std::string, std::string>& func_str_map, std::vector<cppnet::Any>& res);
-    bool ParseFuncCall(char* buf, int len, std::string& func_name, const std::map<std::string, std::string>& func_str_map, std::vector<cppnet::Any>& res);
+    // buf is a frame without the delimiter, it's not changed
+    bool ParseFuncCall(const char* buf, int len, std::string& func_name, const std::map<std::string, std::string>& func_str_map, std::vector<cppnet::Any>& res);
     bool ParseFuncList(char* buf, int len, std::map<std::string, std::string>& map);
     //package for every type
     bool PackageFuncRet(char* buf, int& len, int code, const std::string& func_name, const std::map<std::string, std::string>& func_str_map, std::vector<cppnet::Any>& ret);
@@ -34,7 +34,9 @@ void RPCServer::Start(short port, std::string ip) {
 
     _net.SetAcceptCallback(std::bind(&RPCServer::_DoAccept, this, std::placeholders::_1, std::placeholders::_2));
     _net.SetWriteCallback(std::bind(&RPCServer::_DoWrite, this, std::placeholders::_1, std::placeholders::_2));
-    _net.SetReadCallback(std::bind(&RPCServer::_DoRead, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+    _net.SetFrameCallback(std::bind(&RPCServer::_DoFrame, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+    // every request ends with \r\n\r\n
+    _net.SetListenFrameDecoder(port, cppnet::MakeDelimiterFrameDecoder("\r\n\r\n", __max_request_len));
 
     _net.ListenAndAccept(ip, port);
 
@@ -68,35 +70,29 @@ bool RPCServer::RemoveFunc(std::string name) {
     return false;
 }
 
-void RPCServer::_DoRead(cppnet::Handle handle, cppnet::BufferPtr data,
-                         uint32_t len) {
-    uint32_t need_len = 0;
-    for (;;) {
-        char recv_buf[4096] = { 0 };
-        uint32_t read_len = data->ReadUntil(recv_buf, 4096, "\r\n\r\n", strlen("\r\n\r\n"), need_len);
-        //get a comlete message
-        if (read_len > 0) {
-            FuncCallInfo* info = _pool.PoolNew<FuncCallInfo>();
-            if (_need_mutex) {
-                std::unique_lock<std::mutex> lock(_mutex);
-                if (_parse_package->ParseFuncCall(recv_buf + 2, read_len - 2, info->_func_name, _func_map, info->_func_param_ret)) {
-                    info->_socket = handle;
-                    _info_router->PushTask(info);
-                } else {
-                    cppnet::LOG_ERROR("parse function call request failed!");
-                }
-
-            } else {
-                if (_parse_package->ParseFuncCall(recv_buf + 2, read_len - 2, info->_func_name, _func_map, info->_func_param_ret)) {
-                    info->_socket = handle;
-                    _info_router->PushTask(info);
-                } else {
-                    cppnet::LOG_ERROR("parse function call request failed!");
-                }
-            }
+void RPCServer::_DoFrame(cppnet::Handle handle, const char* frame, uint32_t len) {
+    // skip the type of package
+    if (len < 2) {
+        cppnet::LOG_ERROR("function call request is too short!");
+        return;
+    }
+
+    FuncCallInfo* info = _pool.PoolNew<FuncCallInfo>();
+    if (_need_mutex) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_parse_package->ParseFuncCall(frame + 2, (int)len - 2, info->_func_name, _func_map, info->_func_param_ret)) {
+            info->_socket = handle;
+            _info_router->PushTask(info);
+        } else {
+            cppnet::LOG_ERROR("parse function call request failed!");
+        }
 
+    } else {
+        if (_parse_package->ParseFuncCall(frame + 2, (int)len - 2, info->_func_name, _func_map, info->_func_param_ret)) {
+            info->_socket = handle;
+            _info_router->PushTask(info);
         } else {
-            break;
+            cppnet::LOG_ERROR("parse function call request failed!");
         }
     }
 }
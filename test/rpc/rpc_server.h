@@ -10,6 +10,9 @@
 #include "include/cppnet.h"
 #include "common/alloter/alloter_interface.h"
 
+// longer request closes the connection
+static const uint32_t __max_request_len = 4096;
+
 class InfoRouter;
 class ParsePackage;
 class RPCServer {
@@ -27,8 +30,7 @@ public:
     bool RemoveFunc(std::string name);
 
 private:
-    void _DoRead(cppnet::Handle handle, cppnet::BufferPtr data,
-                 uint32_t len);
+    void _DoFrame(cppnet::Handle handle, const char* frame, uint32_t len);
     void _DoWrite(cppnet::Handle handle, uint32_t len);
     void _DoAccept(cppnet::Handle handle, uint32_t err);
     void _PackageAndSend(cppnet::Handle handle, FuncCallInfo* info, int code);
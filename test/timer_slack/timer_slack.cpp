@@ -0,0 +1,61 @@
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+// heartbeat timers of many connections. every timer starts at a random time
+// and runs periodically with the same interval. with slack the timers of one
+// window are run by one wake up, compare wake ups per second of the threads.
+// run: timerslack [timer num] [interval ms] [slack ms] [run seconds]
+
+static std::atomic<uint64_t> __heartbeats(0);
+
+int main(int argc, char** argv) {
+    uint32_t timer_num = argc > 1 ? (uint32_t)atoi(argv[1]) : 100000;
+    uint32_t interval = argc > 2 ? (uint32_t)atoi(argv[2]) : 1000;
+    uint32_t slack = argc > 3 ? (uint32_t)atoi(argv[3]) : 0;
+    uint32_t run_sec = argc > 4 ? (uint32_t)atoi(argv[4]) : 10;
+
+    cppnet::CppNet net;
+    net.Init(1);
+
+    std::mt19937 random(1);
+    for (uint32_t i = 0; i < timer_num; i++) {
+        // start the heartbeat at a random time of the first interval
+        net.AddTimer(random() % interval + 1, [&net, interval, slack](void*) {
+            net.AddTimer(interval, [](void*) { __heartbeats++; }, nullptr, true, slack);
+        });
+    }
+
+    // skip the first interval, all timers are started then
+    std::this_thread::sleep_for(std::chrono::milliseconds(interval + 1000));
+    std::vector<WakeupStat> start_stats;
+    net.GetWakeupStat(start_stats);
+    uint64_t start_heartbeats = __heartbeats;
+
+    std::vector<WakeupStat> stats;
+    for (uint32_t i = 0; i < run_sec; i++) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        net.GetWakeupStat(stats);
+        std::cout << "wake ups per second :";
+        for (auto& stat : stats) {
+            std::cout << " " << stat._wakeups_per_sec;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "timers: " << timer_num << ", interval: " << interval << " ms, slack: " << slack << " ms" << std::endl;
+    for (size_t i = 0; i < stats.size(); i++) {
+        std::cout << "  thread " << i << " : " << (stats[i]._wakeups - start_stats[i]._wakeups) / run_sec
+                  << " wake ups/s" << std::endl;
+    }
+    std::cout << "  heartbeats : " << (__heartbeats - start_heartbeats) / run_sec << " /s" << std::endl;
+    net.Destory();
+}
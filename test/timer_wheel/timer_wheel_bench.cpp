@@ -0,0 +1,101 @@
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include "common/timer/timer.h"
+#include "common/timer/timer_slot.h"
+
+using namespace cppnet;
+
+// timer wheel under a million armed timers. every timer is added again when
+// it times out, and some timers are reset every millisecond like heartbeats
+// of active connections.
+// run: timerwheelbench [timer num] [run seconds] [reset per millisecond]
+
+// intervals are up to 30 seconds
+static const uint32_t __max_interval = 30 * 1000;
+
+static std::mt19937 __random(1);
+static uint64_t __timeout_num = 0;
+
+static uint32_t RandomInterval() {
+    return __random() % __max_interval + 1;
+}
+
+class BenchTimer:
+    public TimerSlot {
+public:
+    BenchTimer(std::shared_ptr<Timer> timer): _timer(timer) {}
+
+    void SetSelf(std::shared_ptr<BenchTimer> self) { _self_ptr = self; }
+
+    void OnTimer() {
+        __timeout_num++;
+        _timer->AddTimer(_self_ptr, RandomInterval());
+    }
+
+private:
+    std::shared_ptr<Timer> _timer;
+    std::weak_ptr<BenchTimer> _self_ptr;
+};
+
+static double NanoPer(std::chrono::steady_clock::time_point start, uint64_t num) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (num > 0 ? num : 1);
+}
+
+int main(int argc, char** argv) {
+    uint32_t timer_num = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000 * 1000;
+    uint32_t run_sec = argc > 2 ? (uint32_t)atoi(argv[2]) : 60;
+    uint32_t reset_num = argc > 3 ? (uint32_t)atoi(argv[3]) : 1000;
+
+    auto timer = MakeTimer1Min();
+    std::vector<std::shared_ptr<BenchTimer>> timers;
+    timers.reserve(timer_num);
+    for (uint32_t i = 0; i < timer_num; i++) {
+        auto t = std::make_shared<BenchTimer>(timer);
+        t->SetSelf(t);
+        timers.push_back(t);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& t : timers) {
+        timer->AddTimer(t, RandomInterval());
+    }
+    double add_ns = NanoPer(start, timer_num);
+
+    // move the wheel by one millisecond like a busy dispatcher
+    uint64_t reset_total = 0;
+    double reset_time = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t ms = 0; ms < run_sec * 1000; ms++) {
+        auto reset_start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < reset_num; i++) {
+            auto& t = timers[__random() % timer_num];
+            timer->RmTimer(t);
+            timer->AddTimer(t, RandomInterval());
+        }
+        reset_time += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - reset_start).count();
+        reset_total += reset_num;
+
+        timer->TimerRun(1);
+    }
+    double total_time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    double run_ns = (total_time - reset_time) / (__timeout_num > 0 ? __timeout_num : 1);
+
+    start = std::chrono::steady_clock::now();
+    for (auto& t : timers) {
+        timer->RmTimer(t);
+    }
+    double rm_ns = NanoPer(start, timer_num);
+
+    std::cout << "timers: " << timer_num << ", run: " << run_sec << " s, reset: "
+              << reset_num << " per ms" << std::endl;
+    std::cout << "  add     : " << add_ns << " ns/timer" << std::endl;
+    std::cout << "  reset   : " << reset_time / (reset_total > 0 ? reset_total : 1) << " ns/timer" << std::endl;
+    std::cout << "  timeout : " << run_ns << " ns/timer (" << __timeout_num << " timers)" << std::endl;
+    std::cout << "  remove  : " << rm_ns << " ns/timer" << std::endl;
+    std::cout << "  total   : " << total_time / 1000000 << " ms" << std::endl;
+}
@@ -0,0 +1,95 @@
+#include <string>
+#include <atomic>
+#include <iostream>
+
+#include "include/cppnet.h"
+#include "common/util/time.h"
+
+using namespace cppnet;
+
+static const int __msg_count = 100;
+static const int __client_count = 10;
+
+std::atomic_int __echo_ok(0);
+std::atomic_int __echo_err(0);
+
+std::string GetMsg(int index) {
+    // larger than one tls record
+    return std::string(20 * 1024, 'a' + index % 26);
+}
+
+struct Context {
+    int         _index = 0;
+    std::string _expect;
+    std::string _recv;
+};
+
+void ReadFunc(Handle handle, cppnet::BufferPtr data, uint32_t len) {
+    auto context = (Context*)handle->GetContext();
+
+    char buf[4096];
+    while (data->GetCanReadLength() > 0) {
+        uint32_t size = data->Read(buf, sizeof(buf));
+        context->_recv.append(buf, size);
+    }
+    if (context->_recv.length() < context->_expect.length()) {
+        return;
+    }
+
+    if (context->_recv == context->_expect) {
+        __echo_ok++;
+
+    } else {
+        __echo_err++;
+    }
+
+    context->_index++;
+    if (context->_index >= __msg_count) {
+        handle->Close();
+        return;
+    }
+
+    context->_recv.clear();
+    context->_expect = GetMsg(context->_index);
+    handle->Write(context->_expect.c_str(), (uint32_t)context->_expect.length());
+}
+
+void ConnectFunc(Handle handle, uint32_t error) {
+    if (error != CEC_SUCCESS) {
+        std::cout << "something err while connect : " << error << std::endl;
+        return;
+    }
+
+    auto context = new Context();
+    context->_expect = GetMsg(context->_index);
+    handle->SetContext(context);
+    handle->Write(context->_expect.c_str(), (uint32_t)context->_expect.length());
+}
+
+void DisConnectionFunc(Handle handle, uint32_t err) {
+    delete (Context*)handle->GetContext();
+    handle->SetContext(nullptr);
+}
+
+int main() {
+    cppnet::CppNet net;
+    net.Init(1);
+
+    net.SetConnectionCallback(ConnectFunc);
+    net.SetReadCallback(ReadFunc);
+    net.SetDisconnectionCallback(DisConnectionFunc);
+
+    for (int i = 0; i < __client_count; i++) {
+        net.ConnectionTls("127.0.0.1", 8923);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        if (__echo_ok + __echo_err >= __msg_count * __client_count) {
+            break;
+        }
+        cppnet::Sleep(100);
+    }
+
+    std::cout << "echo ok : " << __echo_ok << ", echo error : " << __echo_err << std::endl;
+    return __echo_ok == __msg_count * __client_count ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#include <string>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+// generate a self-signed certificate for test:
+// openssl req -x509 -newkey rsa:2048 -nodes -days 365 -subj "/CN=localhost" -keyout key.pem -out cert.pem
+
+static const int __buf_len = 2048;
+
+void ReadFunc(Handle handle, cppnet::BufferPtr data, uint32_t len) {
+    char msg_buf[__buf_len] = {0};
+    // send back all recv data
+    while (data->GetCanReadLength() > 0) {
+        uint32_t size = data->Read(msg_buf, __buf_len);
+        handle->Write(msg_buf, size);
+    }
+}
+
+void ConnectFunc(Handle handle, uint32_t error) {
+    if (error == CEC_SUCCESS) {
+        std::string ip;
+        uint16_t port;
+        handle->GetAddress(ip, port);
+        std::cout << "tls handshake done with : " << ip << ":" << port << std::endl;
+
+    } else if (error == CEC_CLOSED) {
+        std::cout << "remote closed connect : " << handle->GetSocket() << std::endl;
+
+    } else {
+        std::cout << "something err while connect : " << error << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string cert_file = "cert.pem";
+    std::string key_file = "key.pem";
+    if (argc >= 3) {
+        cert_file = argv[1];
+        key_file = argv[2];
+    }
+
+    cppnet::CppNet net;
+    net.Init(1);
+
+    net.SetAcceptCallback(ConnectFunc);
+    net.SetReadCallback(ReadFunc);
+    net.SetDisconnectionCallback(ConnectFunc);
+
+    if (!net.ListenAndAcceptTls("0.0.0.0", 8923, cert_file, key_file)) {
+        std::cout << "load certificate failed. usage: tlsserver cert.pem key.pem" << std::endl;
+        return 1;
+    }
+
+    net.Join();
+}
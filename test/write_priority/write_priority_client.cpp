@@ -0,0 +1,64 @@
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+static const uint16_t __port = 8927;
+static const uint32_t __low_len = 1024 * 1024;
+static const uint32_t __low_num = 3;
+static const uint32_t __high_len = 16;
+
+// runs of same char, every message is one run if it's not split
+static std::vector<std::pair<char, uint32_t>> __runs;
+static uint32_t __total_len = 0;
+
+void CheckOrder(Handle handle) {
+    bool ok = __runs.size() == __low_num + 1;
+    std::string order;
+    for (auto& run : __runs) {
+        order.append(1, run.first).append(" ");
+        ok = ok && run.second == (run.first == 'H' ? __high_len : __low_len);
+    }
+    // the high message is sent after the message in flight, not after all
+    ok = ok && __runs.back().first != 'H';
+
+    std::cout << "message order : " << order << (ok ? "ok" : "failed") << std::endl;
+    handle->Close();
+}
+
+void ConnectFunc(Handle handle, uint32_t err) {
+    if (err != CEC_SUCCESS) {
+        std::cout << "connect failed : " << err << std::endl;
+    }
+}
+
+void ReadFunc(Handle handle, BufferPtr data, uint32_t len) {
+    std::string buf(len, '\0');
+    len = data->Read(&buf[0], len);
+    for (uint32_t i = 0; i < len; i++) {
+        if (__runs.empty() || __runs.back().first != buf[i]) {
+            __runs.emplace_back(buf[i], 0);
+        }
+        __runs.back().second++;
+    }
+
+    __total_len += len;
+    if (__total_len == __low_len * __low_num + __high_len) {
+        CheckOrder(handle);
+    }
+}
+
+int main() {
+    cppnet::CppNet net;
+    net.Init(1);
+
+    net.SetConnectionCallback(ConnectFunc);
+    net.SetReadCallback(ReadFunc);
+
+    net.Connection("127.0.0.1", __port);
+
+    net.Join();
+}
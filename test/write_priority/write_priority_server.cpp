@@ -0,0 +1,50 @@
+#include <string>
+#include <iostream>
+
+#include "include/cppnet.h"
+
+using namespace cppnet;
+
+static const uint16_t __port = 8927;
+// send slowly, so bulk data waits in cppnet
+static const uint32_t __send_rate = 1024 * 1024;
+static const uint32_t __low_len = 1024 * 1024;
+static const uint32_t __low_num = 3;
+
+static const std::string __high_data(16, 'H');
+
+void AcceptFunc(Handle handle, uint32_t err) {
+    if (err != CEC_SUCCESS) {
+        return;
+    }
+    handle->SetSendRate(__send_rate);
+
+    // bulk messages 'a', 'b', 'c', then a control message.
+    // the control message goes out when the message being sent is done,
+    // before bulk messages waiting: a H b c, or a b H c if b is in flight
+    for (uint32_t i = 0; i < __low_num; i++) {
+        std::string data(__low_len, (char)('a' + i));
+        if (!handle->Write(data.c_str(), (uint32_t)data.length(), CWP_LOW)) {
+            std::cout << "write low message failed" << std::endl;
+        }
+    }
+    if (!handle->Write(__high_data.c_str(), (uint32_t)__high_data.length(), CWP_HIGH)) {
+        std::cout << "write high message failed" << std::endl;
+    }
+}
+
+void ReadFunc(Handle handle, BufferPtr data, uint32_t len) {
+    data->Clear();
+}
+
+int main() {
+    cppnet::CppNet net;
+    net.Init(1);
+
+    net.SetAcceptCallback(AcceptFunc);
+    net.SetReadCallback(ReadFunc);
+
+    net.ListenAndAccept("0.0.0.0", __port);
+
+    net.Join();
+}